@@ -3,10 +3,23 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "events.h"
 #include "input.h"
 #include "rtc.h"
+#include "swtimers.h"
 #include "utils.h"
 
+#define SHOW_PERIOD         100     // Redraw without screen events (clock, countdown), ms
+
+// Events which may change the standby screen
+#define STBY_SHOW_EVENTS    (EVENT_FLAG(EVENT_INPUT) | EVENT_FLAG(EVENT_RC) | \
+                             EVENT_FLAG(EVENT_BT) | EVENT_FLAG(EVENT_MPC) | \
+                             EVENT_FLAG(EVENT_RTC))
+
+// Ticks alone don't change other screens: spectrum is redrawn on new ADC
+// blocks, animations and polls are paced by software timers
+#define SCREEN_SHOW_EVENTS  ((EventFlags)~EVENT_FLAG(EVENT_TICK))
+
 static Amp amp = {
     .status = AMP_STATUS_STBY,
     .screen = SCREEN_STANDBY,
@@ -20,10 +33,17 @@ Amp *ampGet(void)
 
 void ampRun(void)
 {
+    int32_t showTime = -SHOW_PERIOD;
+
     while (1) {
+        // Sleep until an interrupt posts something to do
+        EventFlags events = eventWait();
+
         utilEnableSwd(SCREEN_STANDBY == amp.screen);
 
-        ampSyncFromOthers();
+        if (events & (EVENT_FLAG(EVENT_BT) | EVENT_FLAG(EVENT_MPC))) {
+            ampSyncFromOthers();
+        }
 
         ampActionGet();
         ampActionRemap();
@@ -31,7 +51,14 @@ void ampRun(void)
 
         ampSyncToOthers();
 
-        ampScreenShow();
+        // Screens are not redrawn on each tick
+        int32_t now = swTimGet(SW_TIM_SYSTEM);
+        EventFlags showEvents = amp.screen == SCREEN_STANDBY ? STBY_SHOW_EVENTS : SCREEN_SHOW_EVENTS;
+
+        if (ampScreenChanged() || (events & showEvents) || now - showTime >= SHOW_PERIOD) {
+            ampScreenShow();
+            showTime = now;
+        }
     }
 }
 
@@ -107,6 +107,7 @@ void ampActionGet(void);
 void ampActionRemap(void);
 void ampActionHandle(void);
 void ampScreenShow(void);
+bool ampScreenChanged(void);
 
 Action ampGetButtons();
 Action ampGetEncoder(void);
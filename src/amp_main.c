@@ -16,7 +16,6 @@
 #include "settings.h"
 #include "spectrum.h"
 #include "swtimers.h"
-#include "timers.h"
 #include "tr/labels.h"
 #include "tuner/rds/demod.h"
 #include "tuner/rds/parser.h"
@@ -1323,7 +1322,7 @@ void ampInit(void)
 
     ampReadSettings();
 
-    timerInit(TIM_SPECTRUM, 99, 35); // 20kHz timer:Dsplay IRQ/PWM and ADC conversion trigger
+    spInitTimer(); // 20kHz timer: Display IRQ/PWM and ADC conversion trigger
     swTimInit();
 
     rdsParserSetCb(rdsParserCb);
@@ -1835,10 +1834,18 @@ void ampScreenShow(void)
 
     canvasDebugFPS();
     canvasDebugTimers();
+    canvasDebugCache();
+    canvasDebugBus();
+    canvasDebugEvents();
 
     glcdSync();
 }
 
+bool ampScreenChanged(void)
+{
+    return priv.screenClear || amp->screen != priv.screenNext;
+}
+
 void ampSetBrightness(int8_t value)
 {
     priv.brightness = value;
@@ -1852,6 +1859,5 @@ void TIM_SPECTRUM_HANDLER(void)
 
         // Callbacks
         ampScreenPwm();
-        spConvertADC();
     }
 }
@@ -1,6 +1,7 @@
 #include "bt.h"
 
 #include "amp.h"
+#include "events.h"
 #include "i2cexp.h"
 #include "hwlibs.h"
 #include "menu.h"
@@ -207,6 +208,7 @@ void USART_BT_HANDLER(void)
     if (LL_USART_IsActiveFlag_RXNE(USART_BT) && LL_USART_IsEnabledIT_RXNE(USART_BT)) {
         char ch = LL_USART_ReceiveData8(USART_BT);
         ringBufPushChar(&rbuf, ch);
+        eventPost(EVENT_BT);
     } else {
         // Call Error function
     }
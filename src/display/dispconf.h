@@ -6,12 +6,19 @@ extern "C" {
 #endif
 
 // Third-party SPI library implementation
-#ifdef _DISP_SPI
+#if defined(_DISP_SPI) && defined(_VIRTUAL)
+#define DISP_WAIT_BUSY()        (void)0
+#define DISP_SPI_INIT()         (void)0
+#define DISP_SPI_SEND_BYTE(x)   virtualSpiSend(x)
+#elif defined(_DISP_SPI)
 #include "spi.h"
 #define SPI_DISPLAY             SPI2
 #define DISP_WAIT_BUSY()        spiWaitBusy(SPI_DISPLAY)
 #define DISP_SPI_INIT()         spiInit(SPI_DISPLAY, false)
 #define DISP_SPI_SEND_BYTE(x)   spiSendByte(SPI_DISPLAY, x)
+#define DISP_SPI_DMA_SEND(data, count, fill, done) \
+                                spiSendDma16(SPI_DISPLAY, data, count, fill, done)
+#define DISP_SPI_DMA_WAIT()     spiWaitDma(SPI_DISPLAY)
 #else
 #define DISP_WAIT_BUSY()        (void)0
 #endif
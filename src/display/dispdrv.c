@@ -1,9 +1,41 @@
 #include "dispdrv.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 
 static volatile uint8_t busData;
 
+static DispdrvStat stat;
+
+// Last column and page address set by DCS commands
+typedef struct {
+    int16_t col0;
+    int16_t col1;
+    int16_t page0;
+    int16_t page1;
+    bool valid;
+    bool update;
+} DcsWindow;
+
+static DcsWindow dcsWin;
+
+#if defined(_DISP_SPI) && !defined(_DISP_FB) && !defined(_COLOR_24BIT) && defined(DISP_SPI_DMA_SEND)
+#define DISPDRV_DMA
+
+#define DISPDRV_DMA_MIN     32      // Shorter transfers are faster without DMA
+#define DISPDRV_LINE_SIZE   128
+
+static color_t lineBuf[2][DISPDRV_LINE_SIZE];
+static uint8_t lineIdx;
+static int16_t linePos;
+
+static void dispdrvDmaDone(void)
+{
+    SET(DISP_CS);
+}
+
+#endif // DISPDRV_DMA
+
 #ifdef _DISP_FB
 
 typedef struct {
@@ -114,6 +146,55 @@ static inline void dispdrvBusOut(void)
 
 #endif // _DISP_SPI
 
+#if defined(_DISP_8BIT) && !defined(_DISP_FB)
+#define DISPDRV_BURST
+
+#define DISPDRV_BURST_REFRESH   1024    // Words between input samples during burst
+
+static bool busBurst;
+static uint16_t busBurstCnt;
+
+__attribute__((always_inline))
+static inline void dispdrvBurstRefresh(void)
+{
+    // Let input handler see actual buttons state during long bursts
+    if (++busBurstCnt >= DISPDRV_BURST_REFRESH) {
+        busBurstCnt = 0;
+        dispdrvBusIn();
+        __asm volatile ("nop");
+        __asm volatile ("nop");
+        __asm volatile ("nop");
+        __asm volatile ("nop");
+        dispdrvBusOut();
+    }
+}
+
+#endif // DISPDRV_BURST
+
+// Keep the bus in output mode while a window is filled
+__attribute__((always_inline))
+static inline void dispdrvBurstBegin(void)
+{
+#ifdef DISPDRV_BURST
+    __asm volatile ("nop");
+    __asm volatile ("nop");
+    __asm volatile ("nop");
+    __asm volatile ("nop");
+    dispdrvBusOut();
+    busBurstCnt = 0;
+    busBurst = true;
+#endif
+}
+
+__attribute__((always_inline))
+static inline void dispdrvBurstEnd(void)
+{
+#ifdef DISPDRV_BURST
+    busBurst = false;
+    dispdrvBusIn();
+#endif
+}
+
 __attribute__((always_inline))
 static inline void dispdrvSendWord(uint16_t data)
 {
@@ -128,6 +209,14 @@ static inline void dispdrvSendWord(uint16_t data)
     __asm volatile ("nop");
     SET(DISP_WR);
 #else
+#ifdef DISPDRV_BURST
+    if (busBurst) {
+        dispdrvSendByte(dataH);
+        dispdrvSendByte(dataL);
+        dispdrvBurstRefresh();
+        return;
+    }
+#endif
 #ifndef _DISP_SPI
     __asm volatile ("nop");
     __asm volatile ("nop");
@@ -152,6 +241,16 @@ static inline void dispdrvSendTriplet(uint16_t data)
     uint8_t dataM = (data & 0x07E0) >> 5;
     uint8_t dataL = (data & 0x001F) << 3;
 
+#ifdef DISPDRV_BURST
+    if (busBurst) {
+        dispdrvSendByte(dataH);
+        dispdrvSendByte(dataM);
+        dispdrvSendByte(dataL);
+        dispdrvBurstRefresh();
+        return;
+    }
+#endif
+
 #ifndef _DISP_SPI
     dispdrvBusOut();
 #endif
@@ -181,6 +280,40 @@ static inline void dispdrvSendColor(color_t data)
 #endif
 }
 
+__attribute__((always_inline))
+static inline void dispdrvPutColor(color_t data)
+{
+#ifdef DISPDRV_DMA
+    lineBuf[lineIdx][linePos++] = data;
+
+    if (linePos >= DISPDRV_LINE_SIZE) {
+        // Fill the other buffer while this one is being sent
+        DISP_SPI_DMA_SEND(lineBuf[lineIdx], (uint32_t)linePos, false, NULL);
+        lineIdx ^= 1;
+        linePos = 0;
+    }
+#else
+    dispdrvSendColor(data);
+#endif
+}
+
+__attribute__((always_inline))
+static inline void dispdrvEndColors(void)
+{
+#ifdef DISPDRV_DMA
+    // CS is released when the rest of line buffer is sent
+    DISP_SPI_DMA_SEND(lineBuf[lineIdx], (uint32_t)linePos, false, dispdrvDmaDone);
+    lineIdx ^= 1;
+    linePos = 0;
+#else
+    dispdrvBurstEnd();
+#ifndef _DISP_FB
+    DISP_WAIT_BUSY();
+    SET(DISP_CS);
+#endif
+#endif
+}
+
 void dispdrvReset(void)
 {
 #ifdef _DISP_BCKL_ENABLED
@@ -233,6 +366,8 @@ static void dispdrvInitPins(void)
 
 void dispdrvInit(void)
 {
+    dcsWin.valid = false;
+
     dispdrvInitPins();
 
     dispdrvReset();
@@ -240,8 +375,17 @@ void dispdrvInit(void)
     dispdrv.init();
 }
 
+void dispdrvWaitDma(void)
+{
+#ifdef DISPDRV_DMA
+    DISP_SPI_DMA_WAIT();
+#endif
+}
+
 void dispdrvSync(void)
 {
+    dispdrvWaitDma();
+
     if (dispdrv.fbSync) {
         dispdrv.fbSync();
     } else {
@@ -269,7 +413,8 @@ uint8_t dispdrvGetBus(void)
     return busData;
 }
 
-void dispdrvSendData8(uint8_t data)
+__attribute__((always_inline))
+static inline void dispdrvWriteData8(uint8_t data)
 {
 #ifdef _DISP_8BIT
     dispdrvBusOut();
@@ -280,16 +425,33 @@ void dispdrvSendData8(uint8_t data)
 #endif
 }
 
+void dispdrvSendData8(uint8_t data)
+{
+    dispdrvWaitDma();
+    stat.params++;
+    dispdrvWriteData8(data);
+}
+
 void dispdrvSendData16(uint16_t data)
 {
+    dispdrvWaitDma();
+    stat.params++;
     dispdrvSendWord(data);
 }
 
 void dispdrvSelectReg8(uint8_t reg)
 {
+    dispdrvWaitDma();
+
+    // Any other command may change address window
+    if (!dcsWin.update && reg != 0x2C) {
+        dcsWin.valid = false;
+    }
+    stat.cmds++;
+
     DISP_WAIT_BUSY();
     CLR(DISP_RS);
-    dispdrvSendData8(reg);
+    dispdrvWriteData8(reg);
     DISP_WAIT_BUSY();
     SET(DISP_RS);
 }
@@ -302,6 +464,8 @@ void dispdrvWriteReg8(uint8_t reg, uint8_t data)
 
 void dispdrvSelectReg16(uint16_t reg)
 {
+    dispdrvWaitDma();
+    stat.cmds++;
     DISP_WAIT_BUSY();
     CLR(DISP_RS);
     dispdrvSendWord(reg);
@@ -312,9 +476,46 @@ void dispdrvSelectReg16(uint16_t reg)
 void dispdrvWriteReg16(uint16_t reg, uint16_t data)
 {
     dispdrvSelectReg16(reg);
+    stat.params++;
     dispdrvSendWord(data);
 }
 
+// Send only changed column/page address of DCS controllers and start memory write
+void dispdrvWriteDcsWindow(int16_t col0, int16_t col1, int16_t page0, int16_t page1)
+{
+    dcsWin.update = true;
+
+    if (!dcsWin.valid || dcsWin.col0 != col0 || dcsWin.col1 != col1) {
+        dispdrvSelectReg8(0x2A); // Column Address Set
+        dispdrvSendData8((col0 >> 8) & 0xFF);
+        dispdrvSendData8((col0 >> 0) & 0xFF);
+        dispdrvSendData8((col1 >> 8) & 0xFF);
+        dispdrvSendData8((col1 >> 0) & 0xFF);
+        dcsWin.col0 = col0;
+        dcsWin.col1 = col1;
+    } else {
+        stat.skipped++;
+    }
+
+    if (!dcsWin.valid || dcsWin.page0 != page0 || dcsWin.page1 != page1) {
+        dispdrvSelectReg8(0x2B); // Page Address Set
+        dispdrvSendData8((page0 >> 8) & 0xFF);
+        dispdrvSendData8((page0 >> 0) & 0xFF);
+        dispdrvSendData8((page1 >> 8) & 0xFF);
+        dispdrvSendData8((page1 >> 0) & 0xFF);
+        dcsWin.page0 = page0;
+        dcsWin.page1 = page1;
+    } else {
+        stat.skipped++;
+    }
+
+    dcsWin.valid = true;
+    dcsWin.update = false;
+
+    // Memory write restarts from window origin
+    dispdrvSelectReg8(0x2C);
+}
+
 #ifdef DISP_RD_Port
 
 __attribute__((always_inline))
@@ -376,6 +577,8 @@ uint16_t dispdrvReadData16(void)
 
 void dispdrvReadReg(uint16_t reg, uint16_t *args, uint8_t nArgs)
 {
+    dispdrvWaitDma();
+    dcsWin.valid = false;
     CLR(DISP_CS);
 
     CLR(DISP_RS);
@@ -392,6 +595,7 @@ void dispdrvReadReg(uint16_t reg, uint16_t *args, uint8_t nArgs)
 __attribute__((always_inline))
 static inline void dispdrvSetWindow(int16_t x, int16_t y, int16_t w, int16_t h)
 {
+    stat.windows++;
 #ifdef _DISP_FB
     fbSetWindow(x, y, w, h);
 #else
@@ -406,8 +610,10 @@ void dispdrvDrawPixel(int16_t x, int16_t y, color_t color)
 #ifdef _DISP_FB
     fbSetPixel(x, y, color);
 #else
+    dispdrvWaitDma();
     CLR(DISP_CS);
 
+    stat.windows++;
     dispdrv.setWindow(x, y, 1, 1);
 
     dispdrvSendColor(color);
@@ -420,17 +626,32 @@ void dispdrvDrawPixel(int16_t x, int16_t y, color_t color)
 void dispdrvDrawRect(int16_t x, int16_t y, int16_t w, int16_t h, color_t color)
 {
 #ifndef _DISP_FB
+    dispdrvWaitDma();
     CLR(DISP_CS);
 #endif
 
     dispdrvSetWindow(x, y, w, h);
 
+#ifdef DISPDRV_DMA
+    uint32_t count = (uint32_t)w * (uint32_t)h;
+
+    // Repeat single color, CPU is free until the next bus access
+    if (count >= DISPDRV_DMA_MIN) {
+        DISP_SPI_DMA_SEND(&color, count, true, dispdrvDmaDone);
+        return;
+    }
+#endif
+
+    dispdrvBurstBegin();
+
     for (int16_t i = 0; i < w; i++) {
         for (int16_t j = 0; j < h; j++) {
             dispdrvSendColor(color);
         }
     }
 
+    dispdrvBurstEnd();
+
 #ifndef _DISP_FB
     DISP_WAIT_BUSY();
     SET(DISP_CS);
@@ -440,11 +661,25 @@ void dispdrvDrawRect(int16_t x, int16_t y, int16_t w, int16_t h, color_t color)
 void dispdrvDrawVertGrad(int16_t x, int16_t y, int16_t w, int16_t h, color_t *gr)
 {
 #ifndef _DISP_FB
+    dispdrvWaitDma();
     CLR(DISP_CS);
 #endif
 
     dispdrvSetWindow(x, y, w, h);
 
+#ifdef DISPDRV_DMA
+    if (h >= DISPDRV_DMA_MIN) {
+        for (int16_t i = 0; i < w; i++) {
+            DISP_SPI_DMA_SEND(gr, (uint32_t)h, false, i == w - 1 ? dispdrvDmaDone : NULL);
+        }
+        // Gradient buffer is owned by caller
+        DISP_SPI_DMA_WAIT();
+        return;
+    }
+#endif
+
+    dispdrvBurstBegin();
+
     for (int16_t i = 0; i < w; i++) {
         color_t *color = gr;
         for (int16_t j = 0; j < h; j++) {
@@ -452,6 +687,8 @@ void dispdrvDrawVertGrad(int16_t x, int16_t y, int16_t w, int16_t h, color_t *gr
         }
     }
 
+    dispdrvBurstEnd();
+
 #ifndef _DISP_FB
     DISP_WAIT_BUSY();
     SET(DISP_CS);
@@ -464,36 +701,70 @@ void dispdrvDrawImage(uint8_t *imgData, int16_t imgWidth,
                       int16_t xOft, int16_t yOft, int16_t w, int16_t h)
 {
 #ifndef _DISP_FB
+    dispdrvWaitDma();
     CLR(DISP_CS);
 #endif
 
     if (portrate) {
         dispdrvSetWindow(y, dispdrv.height - w - x, h, w);
+        dispdrvBurstBegin();
 
         for (int16_t j = 0; j < h; j++) {
             for (int16_t i = w - 1; i >= 0; i--) {
                 uint8_t data = imgData[imgWidth * ((j + yOft) >> 3) + i + xOft];
                 if (j < h) {
-                    dispdrvSendColor(data & (1 << ((j + yOft) & 0x7)) ? color : bgColor);
+                    dispdrvPutColor(data & (1 << ((j + yOft) & 0x7)) ? color : bgColor);
                 }
             }
         }
     } else {
         dispdrvSetWindow(x, y, w, h);
+        dispdrvBurstBegin();
 
         for (int16_t i = 0; i < w; i++) {
             for (int16_t j = 0; j < h; j++) {
                 uint8_t data = imgData[imgWidth * ((j + yOft) >> 3) + i + xOft];
                 if (j < h) {
-                    dispdrvSendColor(data & (1 << ((j + yOft) & 0x7)) ? color : bgColor);
+                    dispdrvPutColor(data & (1 << ((j + yOft) & 0x7)) ? color : bgColor);
                 }
             }
         }
     }
 
+    dispdrvEndColors();
+}
 
+void dispdrvStreamBegin(int16_t x, int16_t y, int16_t w, int16_t h)
+{
 #ifndef _DISP_FB
-    DISP_WAIT_BUSY();
-    SET(DISP_CS);
+    dispdrvWaitDma();
+    CLR(DISP_CS);
 #endif
+
+    dispdrvSetWindow(x, y, w, h);
+    dispdrvBurstBegin();
+}
+
+void dispdrvStreamColors(const color_t *data, int16_t count)
+{
+    for (int16_t i = 0; i < count; i++) {
+        dispdrvPutColor(*data++);
+    }
+}
+
+void dispdrvStreamFill(color_t color, int16_t count)
+{
+    for (int16_t i = 0; i < count; i++) {
+        dispdrvPutColor(color);
+    }
+}
+
+void dispdrvStreamEnd(void)
+{
+    dispdrvEndColors();
+}
+
+const DispdrvStat *dispdrvGetStat(void)
+{
+    return &stat;
 }
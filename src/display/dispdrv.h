@@ -11,6 +11,8 @@ extern "C" {
 #include "hw/stm32f3.h"
 #elif defined (__AVR__)
 #include "hw/avr.h"
+#elif defined (_VIRTUAL)
+#include "hw/host.h"
 #endif
 
 #include "dispconf.h"
@@ -38,11 +40,19 @@ typedef struct _DispDriver {
     int16_t height;
 } DispDriver;
 
+typedef struct {
+    uint32_t cmds;              // Register selects
+    uint32_t params;            // Register data writes
+    uint32_t windows;           // Window setups
+    uint32_t skipped;           // Address commands skipped as unchanged
+} DispdrvStat;
+
 extern const DispDriver dispdrv;
 
 void dispdrvReset(void);
 void dispdrvInit(void);
 
+void dispdrvWaitDma(void);
 void dispdrvSync(void);
 void dispdrvScanIRQ(void);
 
@@ -57,6 +67,8 @@ void dispdrvWriteReg8(uint8_t reg, uint8_t data);
 void dispdrvSelectReg16(uint16_t reg);
 void dispdrvWriteReg16(uint16_t reg, uint16_t data);
 
+void dispdrvWriteDcsWindow(int16_t col0, int16_t col1, int16_t page0, int16_t page1);
+
 uint16_t dispdrvReadData16(void);
 void dispdrvReadReg(uint16_t reg, uint16_t *args, uint8_t nArgs);
 
@@ -70,6 +82,13 @@ void dispdrvDrawImage(uint8_t *imgData, int16_t imgWidth,
                       color_t color, color_t bgColor,
                       int16_t xOft, int16_t yOft, int16_t w, int16_t h);
 
+void dispdrvStreamBegin(int16_t x, int16_t y, int16_t w, int16_t h);
+void dispdrvStreamColors(const color_t *data, int16_t count);
+void dispdrvStreamFill(color_t color, int16_t count);
+void dispdrvStreamEnd(void);
+
+const DispdrvStat *dispdrvGetStat(void);
+
 #ifdef __cplusplus
 }
 #endif
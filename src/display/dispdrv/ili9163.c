@@ -117,19 +117,7 @@ void ili9163SetWindow(int16_t x, int16_t y, int16_t w, int16_t h)
     int16_t x1 = x + w - 1;
     int16_t y1 = y + h - 1;
 
-    dispdrvSelectReg8(0x2A);
-    dispdrvSendData8((y >> 8) & 0xFF);
-    dispdrvSendData8((y >> 0) & 0xFF);
-    dispdrvSendData8((y1 >> 8) & 0xFF);
-    dispdrvSendData8((y1 >> 0) & 0xFF);
-
-    dispdrvSelectReg8(0x2B);
-    dispdrvSendData8((x >> 8) & 0xFF);
-    dispdrvSendData8((x >> 0) & 0xFF);
-    dispdrvSendData8((x1 >> 8) & 0xFF);
-    dispdrvSendData8((x1 >> 0) & 0xFF);
-
-    dispdrvSelectReg8(0x2C);
+    dispdrvWriteDcsWindow(y, y1, x, x1);
 }
 
 const DispDriver dispdrv = {
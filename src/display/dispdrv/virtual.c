@@ -0,0 +1,274 @@
+#include "../dispdrv.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// In-memory DCS panel: column address runs along y like ILI9341 in landscape
+
+typedef struct {
+    uint16_t fb[VIRTUAL_WIDTH * VIRTUAL_HEIGHT];
+    VirtualStat stat;
+
+    bool cs;
+    bool rs;
+    uint16_t bus;               // Data lines driven by MCU
+    uint8_t busIn;              // Data lines pulled by buttons
+
+    uint8_t cmd;
+    uint8_t argc;
+    uint8_t argv[4];
+
+    int16_t col0;
+    int16_t col1;
+    int16_t page0;
+    int16_t page1;
+    int16_t col;
+    int16_t page;
+
+    bool rotate;
+    bool half;
+    uint8_t pixHi;
+} VirtualPanel;
+
+static VirtualPanel panel = {
+    .cs = true,
+    .rs = true,
+    .busIn = 0xFF,
+    .col1 = VIRTUAL_HEIGHT - 1,
+    .page1 = VIRTUAL_WIDTH - 1,
+};
+
+static void virtualPutPixel(uint16_t color)
+{
+    int16_t x = panel.page;
+    int16_t y = panel.col;
+
+    if (panel.rotate) {
+        x = VIRTUAL_WIDTH - 1 - x;
+        y = VIRTUAL_HEIGHT - 1 - y;
+    }
+
+    if (x >= 0 && x < VIRTUAL_WIDTH && y >= 0 && y < VIRTUAL_HEIGHT) {
+        panel.fb[y * VIRTUAL_WIDTH + x] = color;
+    }
+    panel.stat.pixels++;
+
+    if (++panel.col > panel.col1) {
+        panel.col = panel.col0;
+        if (++panel.page > panel.page1) {
+            panel.page = panel.page0;
+        }
+    }
+}
+
+static void virtualParam(uint8_t data)
+{
+    panel.stat.params++;
+
+    if (panel.argc < sizeof(panel.argv)) {
+        panel.argv[panel.argc++] = data;
+    }
+
+    switch (panel.cmd) {
+    case 0x2A: // Column Address Set
+        if (panel.argc == 4) {
+            panel.col0 = (int16_t)(panel.argv[0] << 8 | panel.argv[1]);
+            panel.col1 = (int16_t)(panel.argv[2] << 8 | panel.argv[3]);
+        }
+        break;
+    case 0x2B: // Page Address Set
+        if (panel.argc == 4) {
+            panel.page0 = (int16_t)(panel.argv[0] << 8 | panel.argv[1]);
+            panel.page1 = (int16_t)(panel.argv[2] << 8 | panel.argv[3]);
+        }
+        break;
+    case 0x36: // Memory Access Control
+        panel.rotate = (data & 0xC0) == 0xC0;
+        break;
+    }
+}
+
+// Data latched by WR strobe or by SPI byte
+static void virtualLatch(uint16_t data)
+{
+    if (panel.cs) {
+        panel.stat.lost++;
+        return;
+    }
+
+    panel.stat.cycles++;
+
+    if (!panel.rs) {
+        panel.stat.cmds++;
+        panel.cmd = data & 0xFF;
+        panel.argc = 0;
+        if (panel.cmd == 0x2C) { // Memory Write
+            panel.stat.windows++;
+            panel.col = panel.col0;
+            panel.page = panel.page0;
+            panel.half = false;
+        }
+        return;
+    }
+
+    if (panel.cmd != 0x2C) {
+        virtualParam(data & 0xFF);
+        return;
+    }
+
+#ifdef _DISP_16BIT
+    virtualPutPixel(data);
+#else
+    if (panel.half) {
+        virtualPutPixel((uint16_t)(panel.pixHi << 8 | (data & 0xFF)));
+    } else {
+        panel.pixHi = data & 0xFF;
+    }
+    panel.half = !panel.half;
+#endif
+}
+
+void virtualPinWrite(uint16_t pin, bool value)
+{
+    switch (pin) {
+    case DISP_CS_Pin:
+        if (panel.cs && !value) {
+            panel.stat.selects++;
+        }
+        panel.cs = value;
+        break;
+    case DISP_RS_Pin:
+        panel.rs = value;
+        break;
+    case DISP_WR_Pin:
+        // Data is latched on rising edge
+        if (value) {
+            virtualLatch(panel.bus);
+        }
+        break;
+    }
+}
+
+void virtualBusWrite(uint16_t pin, uint8_t data)
+{
+    if (pin == 0xFF00U) {
+        panel.bus = (uint16_t)((panel.bus & 0x00FF) | (data << 8));
+    } else {
+        panel.bus = (uint16_t)((panel.bus & 0xFF00) | data);
+    }
+}
+
+uint8_t virtualBusRead(uint16_t pin)
+{
+    (void)pin;
+
+    panel.stat.reads++;
+
+    return panel.busIn;
+}
+
+void virtualSpiSend(uint8_t data)
+{
+    virtualLatch(data);
+}
+
+void virtualSetButtons(uint8_t value)
+{
+    // Pressed buttons pull data lines low
+    panel.busIn = (uint8_t)~value;
+}
+
+const VirtualStat *virtualGetStat(void)
+{
+    return &panel.stat;
+}
+
+void virtualResetStat(void)
+{
+    memset(&panel.stat, 0, sizeof(panel.stat));
+}
+
+const uint16_t *virtualGetFb(void)
+{
+    return panel.fb;
+}
+
+bool virtualDumpPpm(const char *name)
+{
+    FILE *f = fopen(name, "wb");
+
+    if (!f) {
+        return false;
+    }
+
+    fprintf(f, "P6\n%d %d\n255\n", VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
+
+    for (int32_t i = 0; i < VIRTUAL_WIDTH * VIRTUAL_HEIGHT; i++) {
+        uint16_t color = panel.fb[i];
+        uint8_t rgb[3];
+
+        rgb[0] = (uint8_t)(((color >> 11) & 0x1F) * 255 / 0x1F);
+        rgb[1] = (uint8_t)(((color >> 5) & 0x3F) * 255 / 0x3F);
+        rgb[2] = (uint8_t)(((color >> 0) & 0x1F) * 255 / 0x1F);
+        fwrite(rgb, sizeof(rgb), 1, f);
+    }
+
+    return fclose(f) == 0;
+}
+
+void virtualInit(void)
+{
+    CLR(DISP_CS);
+
+    dispdrvSelectReg8(0x11); // Sleep Out
+
+    dispdrvSelectReg8(0x3A); // Pixel Format Set
+    dispdrvSendData8(0x55);
+
+    dispdrvSelectReg8(0x36); // Memory Access Control
+    dispdrvSendData8(0x00);
+
+    dispdrvSelectReg8(0x29); // Display ON
+
+    SET(DISP_CS);
+}
+
+void virtualRotate(bool rotate)
+{
+    CLR(DISP_CS);
+
+    dispdrvSelectReg8(0x36); // Memory Access Control
+    dispdrvSendData8(rotate ? 0xC0 : 0x00);
+
+    SET(DISP_CS);
+}
+
+void virtualSleep(bool value)
+{
+    CLR(DISP_CS);
+
+    if (value) {
+        dispdrvSelectReg8(0x10); // Enter Sleep Mode
+    } else {
+        dispdrvSelectReg8(0x11); // Sleep Out
+    }
+
+    SET(DISP_CS);
+}
+
+void virtualSetWindow(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    int16_t x1 = x + w - 1;
+    int16_t y1 = y + h - 1;
+
+    dispdrvWriteDcsWindow(y, y1, x, x1);
+}
+
+const DispDriver dispdrv = {
+    .width = VIRTUAL_WIDTH,
+    .height = VIRTUAL_HEIGHT,
+    .init = virtualInit,
+    .sleep = virtualSleep,
+    .setWindow = virtualSetWindow,
+    .rotate = virtualRotate,
+};
@@ -0,0 +1,49 @@
+#ifndef VIRTUAL_H
+#define VIRTUAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Host build: -D_VIRTUAL -D_DISP_8BIT (or _DISP_16BIT, _DISP_SPI) with glcd.c,
+// dispdrv.c and this driver, providing utilmDelay() on the host side
+
+#ifndef VIRTUAL_WIDTH
+#define VIRTUAL_WIDTH       320
+#endif
+#ifndef VIRTUAL_HEIGHT
+#define VIRTUAL_HEIGHT      240
+#endif
+
+typedef struct {
+    uint32_t selects;           // Chip select cycles
+    uint32_t cmds;              // Command writes
+    uint32_t params;            // Command parameter writes
+    uint32_t windows;           // Memory write starts
+    uint32_t pixels;            // Pixels written to memory
+    uint32_t cycles;            // Bus write cycles: bytes on SPI and 8-bit bus
+    uint32_t reads;             // Bus read cycles
+    uint32_t lost;              // Writes with chip select inactive
+} VirtualStat;
+
+void virtualPinWrite(uint16_t pin, bool value);
+void virtualBusWrite(uint16_t pin, uint8_t data);
+uint8_t virtualBusRead(uint16_t pin);
+void virtualSpiSend(uint8_t data);
+
+void virtualSetButtons(uint8_t value);
+
+const VirtualStat *virtualGetStat(void);
+void virtualResetStat(void);
+
+const uint16_t *virtualGetFb(void);
+bool virtualDumpPpm(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VIRTUAL_H
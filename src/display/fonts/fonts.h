@@ -31,7 +31,7 @@ typedef struct {
 
 typedef struct {
     uint16_t length;
-    const __flash tChar *chars;
+    const __flash tChar *chars;     // Sorted by code
 } tFont;
 
 // Originally exported fonts
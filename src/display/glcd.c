@@ -4,7 +4,80 @@
 
 #include "dispdrv.h"
 
+// RAM budget for decoded RLE images, F303CB and F303CC share STM32F303xC
+#ifndef GLCD_CACHE_SIZE
+#if defined(_F303CC)
+#define GLCD_CACHE_SIZE     8192
+#elif defined(_F303CB)
+#define GLCD_CACHE_SIZE     4096
+#elif defined(_F103CB)
+#define GLCD_CACHE_SIZE     1024
+#define GLCD_CACHE_SLOTS    16
+#else
+#define GLCD_CACHE_SIZE     0
+#endif
+#endif
+
+#ifndef GLCD_CACHE_SLOTS
+#define GLCD_CACHE_SLOTS    32
+#endif
+
+#define GLCD_SPAN_IMG_SIZE  256     // Larger RLE images are drawn by spans
+#define GLCD_SPAN_MIN       2       // Shorter solid runs are drawn as mixed bytes
+#define GLCD_SPAN_BUF_SIZE  32
+
+#define GLCD_STR_BUF_SIZE   512     // Composed string part drawn at once
+
+typedef struct {
+    const __flash tImage *img;
+    uint16_t offset;
+    uint16_t size;
+    uint16_t used;              // Last use stamp
+} GlcdCacheSlot;
+
+typedef struct {
+#if GLCD_CACHE_SIZE > 0
+    uint8_t data[GLCD_CACHE_SIZE];
+    GlcdCacheSlot slot[GLCD_CACHE_SLOTS];
+#endif
+    GlcdCacheStat stat;
+    uint16_t stamp;
+} GlcdCache;
+
+typedef struct {
+    int16_t x;                  // Visible part position on screen
+    int16_t y;
+    int16_t xOft;               // Visible part offset inside the area
+    int16_t yOft;
+    int16_t w;
+    int16_t h;
+} GlcdClip;
+
+typedef struct {
+    int16_t x;                  // Screen position of the image origin
+    int16_t y;
+    int16_t xMin;               // Visible part in image coordinates
+    int16_t yMin;
+    int16_t xMax;
+    int16_t yMax;
+    int16_t width;
+    color_t color;
+    color_t bgColor;
+    uint16_t bufPos;
+    uint8_t bufLen;
+    uint8_t buf[GLCD_SPAN_BUF_SIZE];
+} GlcdSpan;
+
+typedef struct {
+    int16_t x;                  // Pixels of a thin line merged to a rectangle
+    int16_t y;
+    int16_t w;
+    int16_t h;
+    color_t color;
+} GlcdRun;
+
 static Glcd glcd;
+static GlcdCache cache;
 
 static void glcdUnRleImg(const __flash tImage *img, uint8_t *data)
 {
@@ -39,6 +112,181 @@ static void glcdUnRleImg(const __flash tImage *img, uint8_t *data)
     }
 }
 
+#if GLCD_CACHE_SIZE > 0
+
+static void glcdCacheEvict(uint8_t idx)
+{
+    GlcdCacheSlot *slot = &cache.slot[idx];
+
+    // Keep cached data packed, free space is always at the end
+    uint16_t tail = slot->offset + slot->size;
+    memmove(&cache.data[slot->offset], &cache.data[tail], cache.stat.used - tail);
+
+    for (uint8_t i = 0; i < cache.stat.count; i++) {
+        if (cache.slot[i].offset > slot->offset) {
+            cache.slot[i].offset -= slot->size;
+        }
+    }
+    cache.stat.used -= slot->size;
+
+    *slot = cache.slot[--cache.stat.count];
+}
+
+static uint8_t *glcdCacheGet(const __flash tImage *img, uint16_t size)
+{
+    cache.stamp++;
+
+    for (uint8_t i = 0; i < cache.stat.count; i++) {
+        GlcdCacheSlot *slot = &cache.slot[i];
+        if (slot->img == img) {
+            slot->used = cache.stamp;
+            cache.stat.hits++;
+            return &cache.data[slot->offset];
+        }
+    }
+
+    cache.stat.misses++;
+
+    if (size > GLCD_CACHE_SIZE) {
+        return NULL;
+    }
+
+    // Drop least recently used images until the new one fits
+    while (cache.stat.count == GLCD_CACHE_SLOTS || cache.stat.used + size > GLCD_CACHE_SIZE) {
+        uint8_t lru = 0;
+        for (uint8_t i = 1; i < cache.stat.count; i++) {
+            if ((uint16_t)(cache.stamp - cache.slot[i].used) >
+                (uint16_t)(cache.stamp - cache.slot[lru].used)) {
+                lru = i;
+            }
+        }
+        glcdCacheEvict(lru);
+    }
+
+    GlcdCacheSlot *slot = &cache.slot[cache.stat.count++];
+    slot->img = img;
+    slot->offset = cache.stat.used;
+    slot->size = size;
+    slot->used = cache.stamp;
+    cache.stat.used += size;
+
+    uint8_t *data = &cache.data[slot->offset];
+    glcdUnRleImg(img, data);
+
+    return data;
+}
+
+#endif // GLCD_CACHE_SIZE > 0
+
+// Draw mixed bytes collected from a single page of the image
+static void glcdSpanFlush(GlcdSpan *sp)
+{
+    if (sp->bufLen == 0) {
+        return;
+    }
+
+    int16_t col = (int16_t)(sp->bufPos % sp->width);
+    int16_t row = (int16_t)(sp->bufPos / sp->width * 8);
+
+    int16_t x0 = col > sp->xMin ? col : sp->xMin;
+    int16_t x1 = col + sp->bufLen < sp->xMax ? col + sp->bufLen : sp->xMax;
+    int16_t y0 = row > sp->yMin ? row : sp->yMin;
+    int16_t y1 = row + 8 < sp->yMax ? row + 8 : sp->yMax;
+
+    if (x0 < x1 && y0 < y1) {
+        dispdrvDrawImage(sp->buf, sp->bufLen,
+                         glcd.orientation & GLCD_PORTRATE, sp->x + x0, sp->y + y0,
+                         sp->color, sp->bgColor,
+                         x0 - col, y0 - row, x1 - x0, y1 - y0);
+    }
+
+    sp->bufLen = 0;
+}
+
+static void glcdSpanPutByte(GlcdSpan *sp, uint16_t pos, uint8_t data)
+{
+    if (sp->bufLen == GLCD_SPAN_BUF_SIZE || (sp->bufLen && pos % sp->width == 0)) {
+        glcdSpanFlush(sp);
+    }
+    if (sp->bufLen == 0) {
+        sp->bufPos = pos;
+    }
+    sp->buf[sp->bufLen++] = data;
+}
+
+static void glcdSpanFill(GlcdSpan *sp, uint16_t pos, uint16_t size, uint8_t data)
+{
+    color_t color = data ? sp->color : sp->bgColor;
+
+    glcdSpanFlush(sp);
+
+    while (size) {
+        int16_t col = (int16_t)(pos % sp->width);
+        int16_t row = (int16_t)(pos / sp->width * 8);
+        int16_t w = sp->width - col;
+        int16_t h = 8;
+
+        if (col == 0 && size >= 2 * sp->width) {
+            // Several whole pages at once
+            h = (int16_t)(size / sp->width * 8);
+        } else if (w > size) {
+            w = (int16_t)size;
+        }
+        uint16_t len = (uint16_t)(h / 8 * w);
+
+        int16_t x0 = col > sp->xMin ? col : sp->xMin;
+        int16_t x1 = col + w < sp->xMax ? col + w : sp->xMax;
+        int16_t y0 = row > sp->yMin ? row : sp->yMin;
+        int16_t y1 = row + h < sp->yMax ? row + h : sp->yMax;
+
+        if (x0 < x1 && y0 < y1) {
+            if (glcd.orientation & GLCD_PORTRATE) {
+                dispdrvDrawRect(sp->y + y0, dispdrv.height - (x1 - x0) - (sp->x + x0),
+                                y1 - y0, x1 - x0, color);
+            } else {
+                dispdrvDrawRect(sp->x + x0, sp->y + y0, x1 - x0, y1 - y0, color);
+            }
+        }
+
+        pos += len;
+        size -= len;
+    }
+}
+
+// Walk RLE stream, solid runs become rectangles, other bytes go as small images
+static void glcdDrawRleSpans(const __flash tImage *img, GlcdSpan *sp)
+{
+    const __flash uint8_t *inPtr = img->data;
+    uint16_t pos = 0;
+
+    sp->bufLen = 0;
+
+    while (inPtr < img->data + img->size) {
+        int8_t size = (int8_t)(*inPtr);
+        inPtr++;
+        if (size < 0) {
+            for (uint8_t i = 0; i < -size; i++) {
+                glcdSpanPutByte(sp, pos++, *inPtr++);
+            }
+        } else if (size > 0) {
+            uint8_t data = *inPtr;
+            if ((data == 0x00 || data == 0xFF) && size >= GLCD_SPAN_MIN) {
+                glcdSpanFill(sp, pos, (uint16_t)size, data);
+                pos += (uint16_t)size;
+            } else {
+                for (uint8_t i = 0; i < size; i++) {
+                    glcdSpanPutByte(sp, pos++, data);
+                }
+            }
+            inPtr++;
+        } else {
+            break;
+        }
+    }
+
+    glcdSpanFlush(sp);
+}
+
 static UChar findSymbolCode(const char **string)
 {
     UChar code = 0;
@@ -109,6 +357,8 @@ void glcdSetBacklight(bool value)
 
 void glcdSetBrightness(uint8_t value)
 {
+    dispdrvWaitDma();
+
     if (glcd.drv->setBrightness) {
         glcd.drv->setBrightness(value);
     }
@@ -123,6 +373,8 @@ void glcdSetOrientation(GlcdOrientation value)
 {
     glcd.orientation = value;
 
+    dispdrvWaitDma();
+
     if (glcd.drv->rotate) {
         glcd.drv->rotate(value & GLCD_LANDSCAPE_ROT);
     }
@@ -132,6 +384,8 @@ void glcdSetOrientation(GlcdOrientation value)
 
 void glcdShift(int16_t pos)
 {
+    dispdrvWaitDma();
+
     if (glcd.drv->shift) {
         glcd.drv->shift(pos);
     }
@@ -139,6 +393,8 @@ void glcdShift(int16_t pos)
 
 void glcdSleep(bool value)
 {
+    dispdrvWaitDma();
+
     if (glcd.drv->sleep) {
         glcd.drv->sleep(value);
     }
@@ -146,6 +402,8 @@ void glcdSleep(bool value)
 
 void glcdSetIdle(bool value)
 {
+    dispdrvWaitDma();
+
     if (glcd.drv->setIdle) {
         glcd.drv->setIdle(value);
     }
@@ -252,21 +510,47 @@ void glcdSetY(int16_t y)
     glcd.y = y;
 }
 
-int16_t glcdFontSymbolPos(UChar code)
+static int16_t findSymbolPos(const __flash tFont *font, UChar code)
 {
-    int16_t sPos = -1;
+    // Font chars are sorted by code, compare them as unsigned UTF-8 sequences
+    int16_t lo = 0;
+    int16_t hi = (int16_t)(font->length - 1);
+
+    while (lo <= hi) {
+        int16_t mid = (lo + hi) / 2;
+        uint32_t midCode = (uint32_t)font->chars[mid].code;
+
+        if (midCode == (uint32_t)code) {
+            return mid;
+        } else if (midCode < (uint32_t)code) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    return -1;
+}
 
+int16_t glcdFontSymbolPos(UChar code)
+{
     const __flash tFont *font = glcd.font;
-    for (int16_t i = 0; i < font->length; i++) {
-        if (font->chars[i].code == code) {
-            return i;
-        }
-        if (font->chars[i].code == BLOCK_CHAR) {
-            sPos = i;
+
+    // Fonts having the whole printable ASCII start with it
+    if (code >= 0x20 && code < 0x7F) {
+        int16_t pos = (int16_t)(code - 0x20);
+        if (pos < font->length && font->chars[pos].code == code) {
+            return pos;
         }
     }
 
-    return sPos;
+    int16_t pos = findSymbolPos(font, code);
+
+    if (pos < 0) {
+        pos = findSymbolPos(font, BLOCK_CHAR);
+    }
+
+    return pos;
 }
 
 UChar glcdFontSymbolCode(int16_t pos)
@@ -280,20 +564,14 @@ UChar glcdFontSymbolCode(int16_t pos)
     return BLOCK_CHAR;
 }
 
-void glcdDrawImage(const __flash tImage *img, color_t color, color_t bgColor)
+// Clip area of given size at current position and move position after it
+static bool glcdClipArea(int16_t w, int16_t h, GlcdClip *clip)
 {
-    if (img == NULL) {
-        return;
-    }
-
     GlcdRect *rect = &glcd.rect;
 
     int16_t x = glcd.x;
     int16_t y = glcd.y;
 
-    int16_t w = img->width;
-    int16_t h = img->height;
-
     glcdSetX(x + w);
 
     int16_t xOft = x > 0 ? 0 : -x;
@@ -313,21 +591,75 @@ void glcdDrawImage(const __flash tImage *img, color_t color, color_t bgColor)
     }
 
     if (w <= 0 || h <= 0) {
+        return false;
+    }
+
+    clip->x = x + rect->x;
+    clip->y = y + rect->y;
+    clip->xOft = xOft;
+    clip->yOft = yOft;
+    clip->w = w;
+    clip->h = h;
+
+    return true;
+}
+
+void glcdDrawImage(const __flash tImage *img, color_t color, color_t bgColor)
+{
+    if (img == NULL) {
         return;
     }
 
-    x += rect->x;
-    y += rect->y;
+    GlcdClip clip;
+
+    if (!glcdClipArea(img->width, img->height, &clip)) {
+        return;
+    }
 
     bool portrate = (glcd.orientation & GLCD_PORTRATE);
 
-    uint8_t unRleData[(size_t)(img->width * ((img->height + 7) / 8))];
-    glcdUnRleImg(img, unRleData);
+    uint16_t size = (uint16_t)(img->width * ((img->height + 7) / 8));
+    uint8_t *data = NULL;
+
+    if (img->rle && size >= GLCD_SPAN_IMG_SIZE) {
+        GlcdSpan span = {
+            .x = clip.x - clip.xOft, .y = clip.y - clip.yOft,
+            .xMin = clip.xOft, .yMin = clip.yOft,
+            .xMax = clip.xOft + clip.w, .yMax = clip.yOft + clip.h,
+            .width = img->width,
+            .color = color, .bgColor = bgColor,
+        };
+        glcdDrawRleSpans(img, &span);
+        return;
+    }
 
-    dispdrvDrawImage(unRleData, img->width,
-                     portrate, x, y,
+#ifndef __AVR__
+    if (!img->rle) {
+        data = (uint8_t *)img->data;
+    }
+#endif
+#if GLCD_CACHE_SIZE > 0
+    if (img->rle) {
+        data = glcdCacheGet(img, size);
+    }
+#endif
+
+    // Decode to stack only if the image is not cached
+    uint8_t unRleData[data ? 1 : size];
+    if (data == NULL) {
+        glcdUnRleImg(img, unRleData);
+        data = unRleData;
+    }
+
+    dispdrvDrawImage(data, img->width,
+                     portrate, clip.x, clip.y,
                      color, bgColor,
-                     xOft, yOft, w, h);
+                     clip.xOft, clip.yOft, clip.w, clip.h);
+}
+
+const GlcdCacheStat *glcdGetCacheStat(void)
+{
+    return &cache.stat;
 }
 
 uint16_t glcdStrToUStr(const char *str, UChar *ustr)
@@ -401,71 +733,219 @@ void glcdSetStringFramed(bool framed)
     glcd.strFramed = framed;
 }
 
-int16_t glcdWriteString(const char *string)
+// Glyph position of symbol i, symbols beyond the cached ones are decoded from tail
+static int16_t glcdStrGlyph(const GlcdStr *str, uint16_t i, const char **tail)
+{
+    if (i < GLCD_STR_SIZE) {
+        return str->pos[i];
+    }
+
+    return glcdFontSymbolPos(findSymbolCode(tail));
+}
+
+void glcdStrReset(GlcdStr *str)
+{
+    str->text = NULL;
+}
+
+int16_t glcdStrMeasure(GlcdStr *str, const char *text)
 {
-    if (string == NULL || glcd.font == 0) {
+    if (text == NULL || glcd.font == 0) {
+        str->text = NULL;
+        str->count = 0;
+        str->width = 0;
         return 0;
     }
 
-    if (glcd.fontAlign != GLCD_ALIGN_LEFT) {
-        uint16_t sLen = glcdCalcStringLen(string);
+    // Same text in the same font is already measured
+    if (str->text == text && str->font == glcd.font && str->framed == glcd.strFramed) {
+        return str->width;
+    }
+
+    str->text = text;
+    str->font = glcd.font;
+    str->framed = glcd.strFramed;
+    str->lsp = glcdCalcUCharLen(LETTER_SPACE_CHAR);
+    str->tail = NULL;
+
+    int16_t width = str->framed ? 2 * str->lsp : 0;
+    uint16_t count = 0;
 
-        if (glcd.fontAlign == GLCD_ALIGN_CENTER) {
-            glcdSetX(glcd.x - sLen / 2);
-        } else if (glcd.fontAlign == GLCD_ALIGN_RIGHT) {
-            glcdSetX(glcd.x - sLen);
+    while (text && *text) {
+        int16_t pos = glcdFontSymbolPos(findSymbolCode(&text));
+
+        if (count < GLCD_STR_SIZE) {
+            str->pos[count] = pos;
+        }
+        if (++count == GLCD_STR_SIZE) {
+            str->tail = text;
         }
 
-        // Reset align after string finished
-        glcd.fontAlign = GLCD_ALIGN_LEFT;
+        if (pos >= 0) {
+            width += glcd.font->chars[pos].image->width;
+        }
+        if (text && *text) {
+            width += str->lsp;
+        }
     }
 
-    int16_t sLen = 0;
-    int16_t lsp = glcdCalcUCharLen(LETTER_SPACE_CHAR);
+    str->count = count;
+    str->width = width;
 
-    if (glcd.strFramed) {
-        glcdDrawRect(glcd.x, glcd.y, lsp, glcd.font->chars[0].image->height, glcd.fontBg);
-        sLen += lsp;
-        glcd.x += lsp;
-    }
-    while (*string) {
-        sLen += glcdWriteUChar(findSymbolCode(&string));
-        if (*string) {
-            glcdDrawRect(glcd.x, glcd.y, lsp, glcd.font->chars[0].image->height, glcd.fontBg);
-            sLen += lsp;
-            glcd.x += lsp;
+    return width;
+}
+
+// Compose columns from c0 to c0 + n - 1 of the string as 1-bit image
+static void glcdComposeString(const GlcdStr *str, int16_t c0, int16_t n,
+                              uint8_t pages, uint8_t *buf)
+{
+    memset(buf, 0, (size_t)(n * pages));
+
+    // Letter spaces and frame are left in background color
+    int16_t cx = str->framed ? str->lsp : 0;
+    const char *tail = str->tail;
+
+    for (uint16_t i = 0; i < str->count && cx < c0 + n; i++) {
+        int16_t pos = glcdStrGlyph(str, i, &tail);
+
+        if (pos >= 0) {
+            const __flash tImage *img = str->font->chars[pos].image;
+            int16_t gw = img->width;
+
+            if (cx + gw > c0) {
+                uint16_t size = (uint16_t)(gw * ((img->height + 7) / 8));
+                const uint8_t *data = NULL;
+
+#ifndef __AVR__
+                if (!img->rle) {
+                    data = (const uint8_t *)img->data;
+                }
+#endif
+#if GLCD_CACHE_SIZE > 0
+                if (img->rle) {
+                    data = glcdCacheGet(img, size);
+                }
+#endif
+                uint8_t unRleData[data ? 1 : size];
+                if (data == NULL) {
+                    glcdUnRleImg(img, unRleData);
+                    data = unRleData;
+                }
+
+                int16_t from = cx > c0 ? cx : c0;
+                int16_t to = cx + gw < c0 + n ? cx + gw : c0 + n;
+
+                for (uint8_t p = 0; p < pages; p++) {
+                    for (int16_t col = from; col < to; col++) {
+                        buf[n * p + col - c0] = data[gw * p + col - cx];
+                    }
+                }
+            }
+            cx += gw;
+        }
+        if (i + 1 < str->count) {
+            cx += str->lsp;
         }
     }
-    if (glcd.strFramed) {
-        glcdDrawRect(glcd.x, glcd.y, lsp, glcd.font->chars[0].image->height, glcd.fontBg);
-        sLen += lsp;
-        glcd.x += lsp;
+}
+
+// Draw whole string as a few images instead of a window per glyph and space
+static void glcdWriteStrComposed(const GlcdStr *str)
+{
+    int16_t x = glcd.x;
+    int16_t height = str->font->chars[0].image->height;
+    uint8_t pages = (uint8_t)((height + 7) / 8);
+    int16_t chunk = GLCD_STR_BUF_SIZE / pages;
+
+    bool portrate = (glcd.orientation & GLCD_PORTRATE);
+
+    uint8_t buf[GLCD_STR_BUF_SIZE];
+
+    for (int16_t c0 = 0; c0 < str->width; c0 += chunk) {
+        int16_t n = str->width - c0 < chunk ? str->width - c0 : chunk;
+        GlcdClip clip;
+
+        glcdSetX(x + c0);
+        if (glcdClipArea(n, height, &clip)) {
+            glcdComposeString(str, c0, n, pages, buf);
+            dispdrvDrawImage(buf, n,
+                             portrate, clip.x, clip.y,
+                             glcd.fontFg, glcd.fontBg,
+                             clip.xOft, clip.yOft, clip.w, clip.h);
+        }
     }
 
-    return sLen;
+    glcdSetX(x + str->width);
 }
 
-int16_t glcdCalcStringLen(const char *string)
+static void glcdWriteStrGlyphs(const GlcdStr *str)
 {
-    if (string == NULL || glcd.font == 0) {
-        return 0;
+    int16_t height = str->font->chars[0].image->height;
+    const char *tail = str->tail;
+
+    if (str->framed) {
+        glcdDrawRect(glcd.x, glcd.y, str->lsp, height, glcd.fontBg);
+        glcd.x += str->lsp;
+    }
+    for (uint16_t i = 0; i < str->count; i++) {
+        int16_t pos = glcdStrGlyph(str, i, &tail);
+        if (pos >= 0) {
+            glcdDrawImage(str->font->chars[pos].image, glcd.fontFg, glcd.fontBg);
+        }
+        if (i + 1 < str->count) {
+            glcdDrawRect(glcd.x, glcd.y, str->lsp, height, glcd.fontBg);
+            glcd.x += str->lsp;
+        }
+    }
+    if (str->framed) {
+        glcdDrawRect(glcd.x, glcd.y, str->lsp, height, glcd.fontBg);
+        glcd.x += str->lsp;
     }
+}
 
-    int16_t sLen = 0;
-    int16_t lsp = glcdCalcUCharLen(LETTER_SPACE_CHAR);
+int16_t glcdStrWrite(const GlcdStr *str)
+{
+    if (str->text == NULL || str->font == 0) {
+        return 0;
+    }
 
-    if (glcd.strFramed) {
-        sLen += 2 * lsp;
+    if (glcd.fontAlign == GLCD_ALIGN_CENTER) {
+        glcdSetX(glcd.x - str->width / 2);
+    } else if (glcd.fontAlign == GLCD_ALIGN_RIGHT) {
+        glcdSetX(glcd.x - str->width);
     }
 
-    while (*string) {
-        sLen += glcdCalcUCharLen(findSymbolCode(&string));
-        if (*string) {
-            sLen += lsp;
-        }
+    // Reset align after string finished
+    glcd.fontAlign = GLCD_ALIGN_LEFT;
+
+    const __flash tImage *fImg = str->font->chars[0].image;
+
+    if (fImg->width * ((fImg->height + 7) / 8) < GLCD_SPAN_IMG_SIZE) {
+        glcdWriteStrComposed(str);
+    } else {
+        glcdWriteStrGlyphs(str);
     }
 
-    return sLen;
+    return str->width;
+}
+
+int16_t glcdWriteString(const char *string)
+{
+    GlcdStr str;
+
+    glcdStrReset(&str);
+    glcdStrMeasure(&str, string);
+
+    return glcdStrWrite(&str);
+}
+
+int16_t glcdCalcStringLen(const char *string)
+{
+    GlcdStr str;
+
+    glcdStrReset(&str);
+
+    return glcdStrMeasure(&str, string);
 }
 
 void glcdDrawPixel(int16_t x, int16_t y, color_t color)
@@ -565,12 +1045,185 @@ void glcdDrawVertGrad(int16_t x, int16_t y, int16_t w, int16_t h, color_t *gr)
     bool portrate = (glcd.orientation & GLCD_PORTRATE);
 
     if (portrate) {
-        dispdrvDrawVertGrad(y, dispdrv.height - w - x, h, w, gr);
+        // Gradient goes across panel columns here, each row is one color
+        dispdrvStreamBegin(y, dispdrv.height - w - x, h, w);
+        for (int16_t j = 0; j < h; j++) {
+            dispdrvStreamFill(gr[j], w);
+        }
+        dispdrvStreamEnd();
     } else {
         dispdrvDrawVertGrad(x, y, w, h, gr);
     }
 }
 
+// Pixels go in native order: landscape - columns left to right, each top to bottom,
+// portrait - rows top to bottom, each right to left
+bool glcdStreamBegin(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    GlcdRect *rect = &glcd.rect;
+
+    // Stream order can't be clipped
+    if (w <= 0 || h <= 0 || x < 0 || y < 0 || x + w > rect->w || y + h > rect->h) {
+        return false;
+    }
+
+    x += rect->x;
+    y += rect->y;
+
+    bool portrate = (glcd.orientation & GLCD_PORTRATE);
+
+    if (portrate) {
+        dispdrvStreamBegin(y, dispdrv.height - w - x, h, w);
+    } else {
+        dispdrvStreamBegin(x, y, w, h);
+    }
+
+    return true;
+}
+
+void glcdStreamColors(const color_t *data, int16_t count)
+{
+    dispdrvStreamColors(data, count);
+}
+
+void glcdStreamEnd(void)
+{
+    dispdrvStreamEnd();
+}
+
+static void glcdRunFlush(GlcdRun *run)
+{
+    glcdDrawRect(run->x, run->y, run->w, run->h, run->color);
+    run->w = 0;
+}
+
+// Extend current run by adjacent pixel or draw it and start a new one
+static void glcdRunPut(GlcdRun *run, int16_t x, int16_t y)
+{
+    if (run->w) {
+        if (run->h == 1 && y == run->y) {
+            if (x == run->x + run->w) {
+                run->w++;
+                return;
+            }
+            if (x == run->x - 1) {
+                run->x--;
+                run->w++;
+                return;
+            }
+        }
+        if (run->w == 1 && x == run->x) {
+            if (y == run->y + run->h) {
+                run->h++;
+                return;
+            }
+            if (y == run->y - 1) {
+                run->y--;
+                run->h++;
+                return;
+            }
+        }
+        glcdRunFlush(run);
+    }
+
+    run->x = x;
+    run->y = y;
+    run->w = 1;
+    run->h = 1;
+}
+
+// Inner block of rows k..x with half width y joined with outer rows +-y of half width x
+static void glcdDrawCircleRows(int16_t xc, int16_t yc, int16_t x, int16_t y, int16_t k,
+                               color_t color)
+{
+    if (k == 0) {
+        glcdDrawRect(xc - y, yc - x, 2 * y + 1, 2 * x + 1, color);
+    } else {
+        glcdDrawRect(xc - y, yc + k, 2 * y + 1, x - k + 1, color);
+        glcdDrawRect(xc - y, yc - x, 2 * y + 1, x - k + 1, color);
+    }
+    if (y > x) {
+        glcdDrawRect(xc - x, yc + y, 2 * x + 1, 1, color);
+        glcdDrawRect(xc - x, yc - y, 2 * x + 1, 1, color);
+    }
+}
+
+// Octant spans of steps y0..y1 having the same xi..xo as a few rectangles
+static void glcdDrawArcSteps(int16_t xl, int16_t xr, int16_t yt, int16_t yb,
+                             int16_t y0, int16_t y1, int16_t xi, int16_t xo, color_t color)
+{
+    int16_t n = y1 - y0 + 1;
+    int16_t t = xo - xi + 1;
+
+    if (y0 == 0 && yt == yb) {
+        glcdDrawRect(xr + xi, yt - y1, t, 2 * y1 + 1, color);
+        glcdDrawRect(xl - xo, yt - y1, t, 2 * y1 + 1, color);
+    } else {
+        glcdDrawRect(xr + xi, yb + y0, t, n, color);
+        glcdDrawRect(xl - xo, yb + y0, t, n, color);
+        glcdDrawRect(xl - xo, yt - y1, t, n, color);
+        glcdDrawRect(xr + xi, yt - y1, t, n, color);
+    }
+
+    if (y0 == 0 && xl == xr) {
+        glcdDrawRect(xl - y1, yb + xi, 2 * y1 + 1, t, color);
+        glcdDrawRect(xl - y1, yt - xo, 2 * y1 + 1, t, color);
+    } else {
+        glcdDrawRect(xr + y0, yb + xi, n, t, color);
+        glcdDrawRect(xl - y1, yb + xi, n, t, color);
+        glcdDrawRect(xl - y1, yt - xo, n, t, color);
+        glcdDrawRect(xr + y0, yt - xo, n, t, color);
+    }
+}
+
+// Midpoint ring with corners centered at xl/xr and yt/yb
+static void glcdDrawArcs(int16_t xl, int16_t xr, int16_t yt, int16_t yb,
+                         int16_t r, int16_t t, color_t color)
+{
+    int16_t xo = r;
+    int16_t xi = xo - t + 1;
+    int16_t y = 0;
+    int16_t erro = 1 - xo;
+    int16_t erri = 1 - xi;
+
+    int16_t y0 = 0;
+    int16_t xi0 = xi;
+    int16_t xo0 = xo;
+
+    while (xo >= y) {
+        if (xi != xi0 || xo != xo0) {
+            glcdDrawArcSteps(xl, xr, yt, yb, y0, y - 1, xi0, xo0, color);
+            y0 = y;
+            xi0 = xi;
+            xo0 = xo;
+        }
+
+        y++;
+
+        if (erro < 0) {
+            erro += 2 * y + 1;
+        } else {
+            xo--;
+            erro += 2 * (y - xo + 1);
+        }
+
+        if (y > xo - t + 1) {
+            xi = y;
+        } else {
+            if (erri < 0) {
+                erri += 2 * y + 1;
+            } else {
+                xi--;
+                erri += 2 * (y - xi + 1);
+            }
+        }
+    }
+
+    if (y > y0) {
+        glcdDrawArcSteps(xl, xr, yt, yb, y0, y - 1, xi0, xo0, color);
+    }
+}
+
 void glcdDrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, color_t color)
 {
     if (x0 == x1) {                 // Vertical
@@ -589,6 +1242,7 @@ void glcdDrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, color_t color)
         glcdDrawRect(x0, y0, x1 - x0 + 1, 1, color);
     } else {
         int16_t sX, sY, dX, dY, err;
+        GlcdRun run = {.w = 0, .color = color};
 
         sX = x0 < x1 ? 1 : -1;
         sY = y0 < y1 ? 1 : -1;
@@ -597,7 +1251,7 @@ void glcdDrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, color_t color)
         err = dX - dY;
 
         while (x0 != x1 || y0 != y1) {
-            glcdDrawPixel(x0, y0, color);
+            glcdRunPut(&run, x0, y0);
             int16_t err2 = err * 2;
             if (err2 > -dY / 2) {
                 err -= dY;
@@ -608,7 +1262,8 @@ void glcdDrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, color_t color)
                 y0 += sY;
             }
         }
-        glcdDrawPixel(x1, y1, color);
+        glcdRunPut(&run, x1, y1);
+        glcdRunFlush(&run);
     }
 }
 
@@ -622,47 +1277,7 @@ void glcdDrawFrame(int16_t x, int16_t y, int16_t w, int16_t h, int16_t t, color_
 
 void glcdDrawRFrame(int16_t x, int16_t y, int16_t w, int16_t h, int16_t t, int16_t r, color_t color)
 {
-    int16_t xc = x + r;
-    int16_t yc = y + r;
-
-    int16_t xo = r;
-    int16_t xi = xo - t + 1;
-    int16_t yo = 0;
-    int16_t erro = 1 - xo;
-    int16_t erri = 1 - xi;
-
-    while (xo >= yo) {
-        glcdDrawLine(xc + xi + w - 2 * r - 1, yc + yo + h - 2 * r - 1, xc + xo + w - 2 * r - 1,
-                     yc + yo + h - 2 * r - 1, color);
-        glcdDrawLine(xc + yo + w - 2 * r - 1, yc + xi + h - 2 * r - 1, xc + yo + w - 2 * r - 1,
-                     yc + xo + h - 2 * r - 1, color);
-        glcdDrawLine(xc - xo, yc + yo + h - 2 * r - 1, xc - xi, yc + yo + h - 2 * r - 1, color);
-        glcdDrawLine(xc - yo, yc + xi + h - 2 * r - 1, xc - yo, yc + xo + h - 2 * r - 1, color);
-        glcdDrawLine(xc - xo, yc - yo, xc - xi, yc - yo, color);
-        glcdDrawLine(xc - yo, yc - xo, xc - yo, yc - xi, color);
-        glcdDrawLine(xc + xi + w - 2 * r - 1, yc - yo, xc + xo + w - 2 * r - 1, yc - yo, color);
-        glcdDrawLine(xc + yo + w - 2 * r - 1, yc - xo, xc + yo + w - 2 * r - 1, yc - xi, color);
-
-        yo++;
-
-        if (erro < 0) {
-            erro += 2 * yo + 1;
-        } else {
-            xo--;
-            erro += 2 * (yo - xo + 1);
-        }
-
-        if (yo > xo - t + 1) {
-            xi = yo;
-        } else {
-            if (erri < 0) {
-                erri += 2 * yo + 1;
-            } else {
-                xi--;
-                erri += 2 * (yo - xi + 1);
-            }
-        }
-    }
+    glcdDrawArcs(x + r, x + w - 1 - r, y + r, y + h - 1 - r, r, t, color);
 
     glcdDrawRect(x + r + 1, y, w - 2 * r - 2, t,  color);
     glcdDrawRect(x, y + r + 1, t, h - 2 * r - 2, color);
@@ -678,9 +1293,12 @@ void glcdDrawCircle(int16_t xc, int16_t yc, int16_t r,
     int16_t ddF_y = -2 * r;
     int16_t x = 0;
     int16_t y = r;
+    int16_t k = 0;
 
     while (x < y) {
         if (f >= 0) {
+            glcdDrawCircleRows(xc, yc, x, y, k, color);
+            k = x + 1;
             y--;
             ddF_y += 2;
             f += ddF_y;
@@ -688,52 +1306,14 @@ void glcdDrawCircle(int16_t xc, int16_t yc, int16_t r,
         x++;
         ddF_x += 2;
         f += ddF_x;
-
-        glcdDrawLine(xc - x, yc + y, xc + x, yc + y, color);
-        glcdDrawLine(xc - x, yc - y, xc + x, yc - y, color);
-        glcdDrawLine(xc - y, yc - x, xc - y, yc + x, color);
-        glcdDrawLine(xc + y, yc - x, xc + y, yc + x, color);
     }
 
-    glcdDrawRect(xc - x, yc - y, 2 * x, 2 * y, color);
+    if (x > 0) {
+        glcdDrawCircleRows(xc, yc, x, y, k, color);
+    }
 }
 
 void glcdDrawRing(int16_t xc, int16_t yc, int16_t r, int16_t t, color_t color)
 {
-    int16_t xo = r;
-    int16_t xi = xo - t + 1;
-    int16_t y = 0;
-    int16_t erro = 1 - xo;
-    int16_t erri = 1 - xi;
-
-    while (xo >= y) {
-        glcdDrawLine(xc + xi, yc + y, xc + xo, yc + y, color);
-        glcdDrawLine(xc + y, yc + xi, xc + y, yc + xo, color);
-        glcdDrawLine(xc - xo, yc + y, xc - xi, yc + y, color);
-        glcdDrawLine(xc - y, yc + xi, xc - y, yc + xo, color);
-        glcdDrawLine(xc - xo, yc - y, xc - xi, yc - y, color);
-        glcdDrawLine(xc - y, yc - xo, xc - y, yc - xi, color);
-        glcdDrawLine(xc + xi, yc - y, xc + xo, yc - y, color);
-        glcdDrawLine(xc + y, yc - xo, xc + y, yc - xi, color);
-
-        y++;
-
-        if (erro < 0) {
-            erro += 2 * y + 1;
-        } else {
-            xo--;
-            erro += 2 * (y - xo + 1);
-        }
-
-        if (y > xo - t + 1) {
-            xi = y;
-        } else {
-            if (erri < 0) {
-                erri += 2 * y + 1;
-            } else {
-                xi--;
-                erri += 2 * (y - xi + 1);
-            }
-        }
-    }
+    glcdDrawArcs(xc, xc, yc, yc, r, t, color);
 }
@@ -55,6 +55,28 @@ typedef struct {
 
 typedef int32_t UChar;
 
+#define GLCD_STR_SIZE   64          // Symbols with cached glyph positions
+
+// Measured string: glyph positions and width, valid while text pointer and font are
+// the same. Text changed in place must be followed by glcdStrReset().
+typedef struct {
+    const char *text;
+    const __flash tFont *font;
+    const char *tail;               // Rest of text after cached symbols
+    uint16_t count;
+    int16_t width;
+    int16_t lsp;
+    bool framed;
+    int16_t pos[GLCD_STR_SIZE];
+} GlcdStr;
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint16_t used;
+    uint8_t count;
+} GlcdCacheStat;
+
 void glcdInit(GlcdOrientation value);
 uint8_t glcdGetBus(void);
 
@@ -90,6 +112,7 @@ int16_t glcdFontSymbolPos(UChar code);
 UChar glcdFontSymbolCode(int16_t pos);
 
 void glcdDrawImage(const __flash tImage *img, color_t color, color_t bgColor);
+const GlcdCacheStat *glcdGetCacheStat(void);
 
 uint16_t glcdStrToUStr(const char *str, UChar *ustr);
 void glcdUStrToStr(const UChar *ustr, char *str);
@@ -101,12 +124,20 @@ void glcdSetStringFramed(bool framed);
 int16_t glcdWriteString(const char *string);
 int16_t glcdCalcStringLen(const char *string);
 
+void glcdStrReset(GlcdStr *str);
+int16_t glcdStrMeasure(GlcdStr *str, const char *text);
+int16_t glcdStrWrite(const GlcdStr *str);
+
 void glcdDrawPixel(int16_t x, int16_t y, color_t color);
 
 void glcdDrawRect(int16_t x, int16_t y, int16_t w, int16_t h, color_t color);
 
 void glcdDrawVertGrad(int16_t x, int16_t y, int16_t w, int16_t h, color_t *gr);
 
+bool glcdStreamBegin(int16_t x, int16_t y, int16_t w, int16_t h);
+void glcdStreamColors(const color_t *data, int16_t count);
+void glcdStreamEnd(void);
+
 void glcdDrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, color_t color);
 
 void glcdDrawFrame(int16_t x, int16_t y, int16_t w, int16_t h, int16_t t, color_t color);
@@ -0,0 +1,29 @@
+#ifndef HOST_H
+#define HOST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../dispdrv/virtual.h"
+
+#define CONCAT(x,y)             x ## y
+
+// Pins and data lines of the virtual panel
+#define SET(p)                  virtualPinWrite(CONCAT(p, _Pin), true)
+#define CLR(p)                  virtualPinWrite(CONCAT(p, _Pin), false)
+
+#define READ(p)                 0
+
+#define OUT(p)                  (void)0
+
+#define READ_BYTE(p)            virtualBusRead(CONCAT(p, _Pin))
+#define WRITE_BYTE(p, data)     virtualBusWrite(CONCAT(p, _Pin), data)
+#define IN_BYTE(p)              (void)0
+#define OUT_BYTE(p)             (void)0
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_H
@@ -0,0 +1,91 @@
+#include "events.h"
+
+#include <string.h>
+
+#include "hwlibs.h"
+#include "swtimers.h"
+
+static volatile uint8_t pending[EVENT_END];
+static volatile uint32_t postTime[EVENT_END];
+
+static EventStats stats;
+static int32_t statTime;
+static uint32_t busyStart;
+static uint32_t busyCycles;
+
+void eventPost(Event ev)
+{
+    // Keep time of the first post until the main loop takes it
+    if (!pending[ev]) {
+        postTime[ev] = DWT->CYCCNT;
+        pending[ev] = 1;
+    }
+}
+
+// Interrupts are disabled here
+static EventFlags eventTake(void)
+{
+    EventFlags flags = 0;
+    uint32_t now = DWT->CYCCNT;
+    uint32_t cyclesInUs = SystemCoreClock / 1000000;
+
+    for (Event ev = 0; ev < EVENT_END; ev++) {
+        if (pending[ev]) {
+            pending[ev] = 0;
+            flags |= EVENT_FLAG(ev);
+
+            EventStat *stat = &stats.event[ev];
+            stat->last = (now - postTime[ev]) / cyclesInUs;
+            if (stat->max < stat->last) {
+                stat->max = stat->last;
+            }
+            stat->count++;
+        }
+    }
+
+    return flags;
+}
+
+EventFlags eventWait(void)
+{
+    EventFlags flags;
+
+    __disable_irq();
+
+    while ((flags = eventTake()) == 0) {
+        uint32_t cyclesInUs = SystemCoreClock / 1000000;
+
+        // CYCCNT may stop in WFI, so only awake cycles are counted
+        busyCycles += DWT->CYCCNT - busyStart;
+        stats.busy += busyCycles / cyclesInUs;
+        busyCycles %= cyclesInUs;
+
+        // Pending interrupt wakes the core even when it is masked
+        __WFI();
+        busyStart = DWT->CYCCNT;
+
+        // Let the interrupt run and post its event
+        __enable_irq();
+        __disable_irq();
+    }
+
+    __enable_irq();
+
+    stats.time = (uint32_t)(swTimGet(SW_TIM_SYSTEM) - statTime);
+    stats.wakes++;
+
+    return flags;
+}
+
+const EventStats *eventGetStats(void)
+{
+    return &stats;
+}
+
+void eventResetStats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    statTime = swTimGet(SW_TIM_SYSTEM);
+    busyStart = DWT->CYCCNT;
+    busyCycles = 0;
+}
@@ -0,0 +1,54 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+typedef uint8_t Event;
+enum {
+    EVENT_TICK = 0,     // SysTick, software timers changed
+    EVENT_INPUT,        // Buttons or encoder changed
+    EVENT_RC,           // Remote control command received
+    EVENT_BT,           // Data from Bluetooth module
+    EVENT_MPC,          // Data from media player
+    EVENT_SPECTRUM,     // ADC block completed
+    EVENT_RTC,          // RTC second
+    EVENT_TIMER,        // Software timer counted down to zero
+
+    EVENT_END,
+};
+
+#define EVENT_FLAG(ev)  ((EventFlags)(1 << (ev)))
+
+typedef uint16_t EventFlags;
+
+typedef struct {
+    uint32_t count;     // Events taken by the main loop
+    uint32_t last;      // Microseconds from post to take
+    uint32_t max;
+} EventStat;
+
+typedef struct {
+    EventStat event[EVENT_END];
+    uint32_t wakes;     // Main loop passes
+    uint32_t time;      // Wall time since reset by SysTick, ms
+    uint32_t busy;      // Time spent out of WFI by CYCCNT, us
+} EventStats;
+
+// Called from interrupts, each event is posted by a single source
+void eventPost(Event ev);
+
+// Take posted events, sleep until any is posted if there are none
+EventFlags eventWait(void);
+
+const EventStats *eventGetStats(void);
+void eventResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVENTS_H
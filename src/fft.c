@@ -1,6 +1,17 @@
 #include "fft.h"
 
-#define N_HANN      1024
+#ifdef _FFT_SIMD
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "cmsis_compiler.h"
+#elif !defined(_DSP_REF)
+#error "_FFT_SIMD needs DSP instructions (__ARM_FEATURE_DSP)"
+#endif
+#endif
+
+// Max block magnitude before a radix-4 stage, it may grow up to ~5.3 times
+#define FFT_BFP_LIMIT   4096
 
 static const int16_t sinTable[N_WAVE / 4 + 1] = {
     0,      201,    402,    603,    804,    1005,   1206,   1406,
@@ -38,6 +49,530 @@ static const int16_t sinTable[N_WAVE / 4 + 1] = {
     32767
 };
 
+// Hamming window, coefficients 0.53836 and 0.46164 scaled by 2^16, symmetric half
+static const uint16_t hammTable[FFT_SIZE / 2] = {
+    5029,  5030,  5032,  5035,  5039,  5044,  5051,  5058,
+    5066,  5076,  5087,  5099,  5112,  5126,  5141,  5158,
+    5175,  5195,  5214,  5235,  5257,  5281,  5305,  5330,
+    5357,  5385,  5414,  5444,  5475,  5508,  5541,  5575,
+    5611,  5648,  5686,  5725,  5765,  5806,  5848,  5892,
+    5936,  5982,  6029,  6076,  6125,  6176,  6227,  6280,
+    6332,  6387,  6443,  6499,  6556,  6616,  6676,  6737,
+    6798,  6861,  6926,  6990,  7057,  7124,  7193,  7262,
+    7333,  7404,  7477,  7551,  7626,  7701,  7778,  7855,
+    7934,  8014,  8096,  8177,  8260,  8344,  8429,  8515,
+    8602,  8690,  8779,  8869,  8960,  9052,  9145,  9239,
+    9334,  9430,  9527,  9624,  9723,  9823,  9924,  10026,
+    10129, 10232, 10336, 10442, 10549, 10656, 10764, 10874,
+    10983, 11094, 11206, 11320, 11433, 11548, 11663, 11779,
+    11897, 12015, 12134, 12254, 12375, 12497, 12619, 12742,
+    12867, 12992, 13118, 13244, 13372, 13500, 13629, 13760,
+    13891, 14022, 14155, 14288, 14422, 14556, 14692, 14829,
+    14966, 15104, 15242, 15382, 15522, 15663, 15805, 15947,
+    16090, 16234, 16379, 16524, 16670, 16817, 16964, 17112,
+    17261, 17410, 17561, 17711, 17863, 18015, 18167, 18321,
+    18475, 18630, 18785, 18941, 19097, 19254, 19412, 19571,
+    19729, 19889, 20049, 20209, 20371, 20533, 20695, 20858,
+    21021, 21185, 21350, 21515, 21680, 21846, 22013, 22180,
+    22348, 22516, 22684, 22853, 23023, 23192, 23363, 23534,
+    23705, 23877, 24049, 24221, 24395, 24568, 24742, 24916,
+    25091, 25265, 25441, 25616, 25792, 25969, 26146, 26323,
+    26500, 26678, 26856, 27035, 27213, 27392, 27571, 27751,
+    27932, 28112, 28292, 28473, 28654, 28835, 29016, 29198,
+    29380, 29562, 29745, 29928, 30110, 30293, 30476, 30660,
+    30843, 31027, 31211, 31395, 31578, 31763, 31948, 32132,
+    32317, 32502, 32686, 32872, 33056, 33242, 33427, 33612,
+    33798, 33983, 34168, 34354, 34539, 34725, 34910, 35096,
+    35281, 35467, 35653, 35838, 36024, 36209, 36395, 36580,
+    36765, 36951, 37136, 37321, 37507, 37691, 37877, 38061,
+    38246, 38431, 38615, 38800, 38985, 39168, 39352, 39536,
+    39720, 39903, 40087, 40270, 40453, 40635, 40818, 41001,
+    41183, 41365, 41547, 41728, 41909, 42090, 42271, 42451,
+    42631, 42812, 42992, 43171, 43350, 43528, 43707, 43885,
+    44063, 44240, 44417, 44594, 44771, 44947, 45122, 45298,
+    45472, 45647, 45821, 45995, 46168, 46342, 46514, 46686,
+    46858, 47029, 47200, 47371, 47540, 47710, 47879, 48047,
+    48215, 48383, 48550, 48717, 48883, 49048, 49213, 49378,
+    49542, 49705, 49868, 50030, 50192, 50354, 50514, 50674,
+    50834, 50992, 51151, 51309, 51466, 51622, 51778, 51933,
+    52088, 52242, 52396, 52548, 52700, 52852, 53002, 53153,
+    53302, 53451, 53599, 53746, 53893, 54039, 54184, 54329,
+    54473, 54616, 54758, 54900, 55041, 55181, 55321, 55459,
+    55597, 55734, 55871, 56007, 56141, 56275, 56408, 56541,
+    56672, 56803, 56934, 57063, 57191, 57319, 57445, 57571,
+    57696, 57821, 57944, 58066, 58188, 58309, 58429, 58548,
+    58666, 58784, 58900, 59015, 59130, 59243, 59357, 59469,
+    59580, 59689, 59799, 59907, 60014, 60121, 60227, 60331,
+    60434, 60537, 60639, 60740, 60840, 60939, 61036, 61133,
+    61229, 61324, 61418, 61511, 61603, 61694, 61784, 61873,
+    61961, 62048, 62134, 62219, 62303, 62386, 62467, 62549,
+    62629, 62708, 62785, 62862, 62937, 63012, 63086, 63159,
+    63230, 63301, 63370, 63439, 63506, 63573, 63637, 63702,
+    63765, 63826, 63887, 63947, 64007, 64064, 64120, 64176,
+    64231, 64283, 64336, 64387, 64438, 64487, 64534, 64581,
+    64627, 64671, 64715, 64757, 64798, 64838, 64877, 64915,
+    64952, 64988, 65022, 65055, 65088, 65119, 65149, 65178,
+    65206, 65233, 65258, 65282, 65306, 65328, 65349, 65368,
+    65388, 65405, 65422, 65437, 65451, 65464, 65476, 65487,
+    65497, 65505, 65512, 65519, 65524, 65528, 65531, 65533,
+};
+
+// Bit-reversal permutation as pairs (i, rev(i)) with i <= rev(i), fixed points included
+#define FFT_REV_PAIRS   528
+
+typedef struct {
+    uint16_t i;
+    uint16_t j;
+} FftRevPair;
+
+static const FftRevPair revTable[FFT_REV_PAIRS] = {
+    {   0,   0 }, {   1, 512 }, {   2, 256 }, {   3, 768 }, {   4, 128 }, {   5, 640 },
+    {   6, 384 }, {   7, 896 }, {   8,  64 }, {   9, 576 }, {  10, 320 }, {  11, 832 },
+    {  12, 192 }, {  13, 704 }, {  14, 448 }, {  15, 960 }, {  16,  32 }, {  17, 544 },
+    {  18, 288 }, {  19, 800 }, {  20, 160 }, {  21, 672 }, {  22, 416 }, {  23, 928 },
+    {  24,  96 }, {  25, 608 }, {  26, 352 }, {  27, 864 }, {  28, 224 }, {  29, 736 },
+    {  30, 480 }, {  31, 992 }, {  33, 528 }, {  34, 272 }, {  35, 784 }, {  36, 144 },
+    {  37, 656 }, {  38, 400 }, {  39, 912 }, {  40,  80 }, {  41, 592 }, {  42, 336 },
+    {  43, 848 }, {  44, 208 }, {  45, 720 }, {  46, 464 }, {  47, 976 }, {  48,  48 },
+    {  49, 560 }, {  50, 304 }, {  51, 816 }, {  52, 176 }, {  53, 688 }, {  54, 432 },
+    {  55, 944 }, {  56, 112 }, {  57, 624 }, {  58, 368 }, {  59, 880 }, {  60, 240 },
+    {  61, 752 }, {  62, 496 }, {  63,1008 }, {  65, 520 }, {  66, 264 }, {  67, 776 },
+    {  68, 136 }, {  69, 648 }, {  70, 392 }, {  71, 904 }, {  72,  72 }, {  73, 584 },
+    {  74, 328 }, {  75, 840 }, {  76, 200 }, {  77, 712 }, {  78, 456 }, {  79, 968 },
+    {  81, 552 }, {  82, 296 }, {  83, 808 }, {  84, 168 }, {  85, 680 }, {  86, 424 },
+    {  87, 936 }, {  88, 104 }, {  89, 616 }, {  90, 360 }, {  91, 872 }, {  92, 232 },
+    {  93, 744 }, {  94, 488 }, {  95,1000 }, {  97, 536 }, {  98, 280 }, {  99, 792 },
+    { 100, 152 }, { 101, 664 }, { 102, 408 }, { 103, 920 }, { 105, 600 }, { 106, 344 },
+    { 107, 856 }, { 108, 216 }, { 109, 728 }, { 110, 472 }, { 111, 984 }, { 113, 568 },
+    { 114, 312 }, { 115, 824 }, { 116, 184 }, { 117, 696 }, { 118, 440 }, { 119, 952 },
+    { 120, 120 }, { 121, 632 }, { 122, 376 }, { 123, 888 }, { 124, 248 }, { 125, 760 },
+    { 126, 504 }, { 127,1016 }, { 129, 516 }, { 130, 260 }, { 131, 772 }, { 132, 132 },
+    { 133, 644 }, { 134, 388 }, { 135, 900 }, { 137, 580 }, { 138, 324 }, { 139, 836 },
+    { 140, 196 }, { 141, 708 }, { 142, 452 }, { 143, 964 }, { 145, 548 }, { 146, 292 },
+    { 147, 804 }, { 148, 164 }, { 149, 676 }, { 150, 420 }, { 151, 932 }, { 153, 612 },
+    { 154, 356 }, { 155, 868 }, { 156, 228 }, { 157, 740 }, { 158, 484 }, { 159, 996 },
+    { 161, 532 }, { 162, 276 }, { 163, 788 }, { 165, 660 }, { 166, 404 }, { 167, 916 },
+    { 169, 596 }, { 170, 340 }, { 171, 852 }, { 172, 212 }, { 173, 724 }, { 174, 468 },
+    { 175, 980 }, { 177, 564 }, { 178, 308 }, { 179, 820 }, { 180, 180 }, { 181, 692 },
+    { 182, 436 }, { 183, 948 }, { 185, 628 }, { 186, 372 }, { 187, 884 }, { 188, 244 },
+    { 189, 756 }, { 190, 500 }, { 191,1012 }, { 193, 524 }, { 194, 268 }, { 195, 780 },
+    { 197, 652 }, { 198, 396 }, { 199, 908 }, { 201, 588 }, { 202, 332 }, { 203, 844 },
+    { 204, 204 }, { 205, 716 }, { 206, 460 }, { 207, 972 }, { 209, 556 }, { 210, 300 },
+    { 211, 812 }, { 213, 684 }, { 214, 428 }, { 215, 940 }, { 217, 620 }, { 218, 364 },
+    { 219, 876 }, { 220, 236 }, { 221, 748 }, { 222, 492 }, { 223,1004 }, { 225, 540 },
+    { 226, 284 }, { 227, 796 }, { 229, 668 }, { 230, 412 }, { 231, 924 }, { 233, 604 },
+    { 234, 348 }, { 235, 860 }, { 237, 732 }, { 238, 476 }, { 239, 988 }, { 241, 572 },
+    { 242, 316 }, { 243, 828 }, { 245, 700 }, { 246, 444 }, { 247, 956 }, { 249, 636 },
+    { 250, 380 }, { 251, 892 }, { 252, 252 }, { 253, 764 }, { 254, 508 }, { 255,1020 },
+    { 257, 514 }, { 258, 258 }, { 259, 770 }, { 261, 642 }, { 262, 386 }, { 263, 898 },
+    { 265, 578 }, { 266, 322 }, { 267, 834 }, { 269, 706 }, { 270, 450 }, { 271, 962 },
+    { 273, 546 }, { 274, 290 }, { 275, 802 }, { 277, 674 }, { 278, 418 }, { 279, 930 },
+    { 281, 610 }, { 282, 354 }, { 283, 866 }, { 285, 738 }, { 286, 482 }, { 287, 994 },
+    { 289, 530 }, { 291, 786 }, { 293, 658 }, { 294, 402 }, { 295, 914 }, { 297, 594 },
+    { 298, 338 }, { 299, 850 }, { 301, 722 }, { 302, 466 }, { 303, 978 }, { 305, 562 },
+    { 306, 306 }, { 307, 818 }, { 309, 690 }, { 310, 434 }, { 311, 946 }, { 313, 626 },
+    { 314, 370 }, { 315, 882 }, { 317, 754 }, { 318, 498 }, { 319,1010 }, { 321, 522 },
+    { 323, 778 }, { 325, 650 }, { 326, 394 }, { 327, 906 }, { 329, 586 }, { 330, 330 },
+    { 331, 842 }, { 333, 714 }, { 334, 458 }, { 335, 970 }, { 337, 554 }, { 339, 810 },
+    { 341, 682 }, { 342, 426 }, { 343, 938 }, { 345, 618 }, { 346, 362 }, { 347, 874 },
+    { 349, 746 }, { 350, 490 }, { 351,1002 }, { 353, 538 }, { 355, 794 }, { 357, 666 },
+    { 358, 410 }, { 359, 922 }, { 361, 602 }, { 363, 858 }, { 365, 730 }, { 366, 474 },
+    { 367, 986 }, { 369, 570 }, { 371, 826 }, { 373, 698 }, { 374, 442 }, { 375, 954 },
+    { 377, 634 }, { 378, 378 }, { 379, 890 }, { 381, 762 }, { 382, 506 }, { 383,1018 },
+    { 385, 518 }, { 387, 774 }, { 389, 646 }, { 390, 390 }, { 391, 902 }, { 393, 582 },
+    { 395, 838 }, { 397, 710 }, { 398, 454 }, { 399, 966 }, { 401, 550 }, { 403, 806 },
+    { 405, 678 }, { 406, 422 }, { 407, 934 }, { 409, 614 }, { 411, 870 }, { 413, 742 },
+    { 414, 486 }, { 415, 998 }, { 417, 534 }, { 419, 790 }, { 421, 662 }, { 423, 918 },
+    { 425, 598 }, { 427, 854 }, { 429, 726 }, { 430, 470 }, { 431, 982 }, { 433, 566 },
+    { 435, 822 }, { 437, 694 }, { 438, 438 }, { 439, 950 }, { 441, 630 }, { 443, 886 },
+    { 445, 758 }, { 446, 502 }, { 447,1014 }, { 449, 526 }, { 451, 782 }, { 453, 654 },
+    { 455, 910 }, { 457, 590 }, { 459, 846 }, { 461, 718 }, { 462, 462 }, { 463, 974 },
+    { 465, 558 }, { 467, 814 }, { 469, 686 }, { 471, 942 }, { 473, 622 }, { 475, 878 },
+    { 477, 750 }, { 478, 494 }, { 479,1006 }, { 481, 542 }, { 483, 798 }, { 485, 670 },
+    { 487, 926 }, { 489, 606 }, { 491, 862 }, { 493, 734 }, { 495, 990 }, { 497, 574 },
+    { 499, 830 }, { 501, 702 }, { 503, 958 }, { 505, 638 }, { 507, 894 }, { 509, 766 },
+    { 510, 510 }, { 511,1022 }, { 513, 513 }, { 515, 769 }, { 517, 641 }, { 519, 897 },
+    { 521, 577 }, { 523, 833 }, { 525, 705 }, { 527, 961 }, { 529, 545 }, { 531, 801 },
+    { 533, 673 }, { 535, 929 }, { 537, 609 }, { 539, 865 }, { 541, 737 }, { 543, 993 },
+    { 547, 785 }, { 549, 657 }, { 551, 913 }, { 553, 593 }, { 555, 849 }, { 557, 721 },
+    { 559, 977 }, { 561, 561 }, { 563, 817 }, { 565, 689 }, { 567, 945 }, { 569, 625 },
+    { 571, 881 }, { 573, 753 }, { 575,1009 }, { 579, 777 }, { 581, 649 }, { 583, 905 },
+    { 585, 585 }, { 587, 841 }, { 589, 713 }, { 591, 969 }, { 595, 809 }, { 597, 681 },
+    { 599, 937 }, { 601, 617 }, { 603, 873 }, { 605, 745 }, { 607,1001 }, { 611, 793 },
+    { 613, 665 }, { 615, 921 }, { 619, 857 }, { 621, 729 }, { 623, 985 }, { 627, 825 },
+    { 629, 697 }, { 631, 953 }, { 633, 633 }, { 635, 889 }, { 637, 761 }, { 639,1017 },
+    { 643, 773 }, { 645, 645 }, { 647, 901 }, { 651, 837 }, { 653, 709 }, { 655, 965 },
+    { 659, 805 }, { 661, 677 }, { 663, 933 }, { 667, 869 }, { 669, 741 }, { 671, 997 },
+    { 675, 789 }, { 679, 917 }, { 683, 853 }, { 685, 725 }, { 687, 981 }, { 691, 821 },
+    { 693, 693 }, { 695, 949 }, { 699, 885 }, { 701, 757 }, { 703,1013 }, { 707, 781 },
+    { 711, 909 }, { 715, 845 }, { 717, 717 }, { 719, 973 }, { 723, 813 }, { 727, 941 },
+    { 731, 877 }, { 733, 749 }, { 735,1005 }, { 739, 797 }, { 743, 925 }, { 747, 861 },
+    { 751, 989 }, { 755, 829 }, { 759, 957 }, { 763, 893 }, { 765, 765 }, { 767,1021 },
+    { 771, 771 }, { 775, 899 }, { 779, 835 }, { 783, 963 }, { 787, 803 }, { 791, 931 },
+    { 795, 867 }, { 799, 995 }, { 807, 915 }, { 811, 851 }, { 815, 979 }, { 819, 819 },
+    { 823, 947 }, { 827, 883 }, { 831,1011 }, { 839, 907 }, { 843, 843 }, { 847, 971 },
+    { 855, 939 }, { 859, 875 }, { 863,1003 }, { 871, 923 }, { 879, 987 }, { 887, 955 },
+    { 891, 891 }, { 895,1019 }, { 903, 903 }, { 911, 967 }, { 919, 935 }, { 927, 999 },
+    { 943, 983 }, { 951, 951 }, { 959,1015 }, { 975, 975 }, { 991,1007 }, {1023,1023 },
+};
+
+// Twiddles for radix-4 stages m = 16..FFT_SIZE in the order butterflies read them:
+// 4 + 16 + 64 + 256 groups, each group is (w^2, w^1, w^3) as cos/sin pairs
+#define FFT_TW_SIZE ((FFT_SIZE - 4) / 3)
+
+typedef struct {
+    int16_t cos2, sin2;
+    int16_t cos1, sin1;
+    int16_t cos3, sin3;
+} FftTwiddle;
+
+static const FftTwiddle twiddle[FFT_TW_SIZE] = {
+    // Stage m = 16
+    {  32767,      0,  32767,      0,  32767,      0 },
+    {  23169,  23169,  30272,  12539,  12539,  30272 },
+    {      0,  32767,  23169,  23169, -23169,  23169 },
+    { -23169,  23169,  12539,  30272, -30272, -12539 },
+    // Stage m = 64
+    {  32767,      0,  32767,      0,  32767,      0 },
+    {  32137,   6392,  32609,   3211,  31356,   9511 },
+    {  30272,  12539,  32137,   6392,  27244,  18204 },
+    {  27244,  18204,  31356,   9511,  20787,  25329 },
+    {  23169,  23169,  30272,  12539,  12539,  30272 },
+    {  18204,  27244,  28897,  15446,   3211,  32609 },
+    {  12539,  30272,  27244,  18204,  -6392,  32137 },
+    {   6392,  32137,  25329,  20787, -15446,  28897 },
+    {      0,  32767,  23169,  23169, -23169,  23169 },
+    {  -6392,  32137,  20787,  25329, -28897,  15446 },
+    { -12539,  30272,  18204,  27244, -32137,   6392 },
+    { -18204,  27244,  15446,  28897, -32609,  -3211 },
+    { -23169,  23169,  12539,  30272, -30272, -12539 },
+    { -27244,  18204,   9511,  31356, -25329, -20787 },
+    { -30272,  12539,   6392,  32137, -18204, -27244 },
+    { -32137,   6392,   3211,  32609,  -9511, -31356 },
+    // Stage m = 256
+    {  32767,      0,  32767,      0,  32767,      0 },
+    {  32727,   1607,  32757,    804,  32678,   2410 },
+    {  32609,   3211,  32727,   1607,  32412,   4807 },
+    {  32412,   4807,  32678,   2410,  31970,   7179 },
+    {  32137,   6392,  32609,   3211,  31356,   9511 },
+    {  31785,   7961,  32520,   4011,  30571,  11792 },
+    {  31356,   9511,  32412,   4807,  29621,  14009 },
+    {  30851,  11038,  32284,   5601,  28510,  16150 },
+    {  30272,  12539,  32137,   6392,  27244,  18204 },
+    {  29621,  14009,  31970,   7179,  25831,  20159 },
+    {  28897,  15446,  31785,   7961,  24278,  22004 },
+    {  28105,  16845,  31580,   8739,  22594,  23731 },
+    {  27244,  18204,  31356,   9511,  20787,  25329 },
+    {  26318,  19519,  31113,  10278,  18867,  26789 },
+    {  25329,  20787,  30851,  11038,  16845,  28105 },
+    {  24278,  22004,  30571,  11792,  14732,  29268 },
+    {  23169,  23169,  30272,  12539,  12539,  30272 },
+    {  22004,  24278,  29955,  13278,  10278,  31113 },
+    {  20787,  25329,  29621,  14009,   7961,  31785 },
+    {  19519,  26318,  29268,  14732,   5601,  32284 },
+    {  18204,  27244,  28897,  15446,   3211,  32609 },
+    {  16845,  28105,  28510,  16150,    804,  32757 },
+    {  15446,  28897,  28105,  16845,  -1607,  32727 },
+    {  14009,  29621,  27683,  17530,  -4011,  32520 },
+    {  12539,  30272,  27244,  18204,  -6392,  32137 },
+    {  11038,  30851,  26789,  18867,  -8739,  31580 },
+    {   9511,  31356,  26318,  19519, -11038,  30851 },
+    {   7961,  31785,  25831,  20159, -13278,  29955 },
+    {   6392,  32137,  25329,  20787, -15446,  28897 },
+    {   4807,  32412,  24811,  21402, -17530,  27683 },
+    {   3211,  32609,  24278,  22004, -19519,  26318 },
+    {   1607,  32727,  23731,  22594, -21402,  24811 },
+    {      0,  32767,  23169,  23169, -23169,  23169 },
+    {  -1607,  32727,  22594,  23731, -24811,  21402 },
+    {  -3211,  32609,  22004,  24278, -26318,  19519 },
+    {  -4807,  32412,  21402,  24811, -27683,  17530 },
+    {  -6392,  32137,  20787,  25329, -28897,  15446 },
+    {  -7961,  31785,  20159,  25831, -29955,  13278 },
+    {  -9511,  31356,  19519,  26318, -30851,  11038 },
+    { -11038,  30851,  18867,  26789, -31580,   8739 },
+    { -12539,  30272,  18204,  27244, -32137,   6392 },
+    { -14009,  29621,  17530,  27683, -32520,   4011 },
+    { -15446,  28897,  16845,  28105, -32727,   1607 },
+    { -16845,  28105,  16150,  28510, -32757,   -804 },
+    { -18204,  27244,  15446,  28897, -32609,  -3211 },
+    { -19519,  26318,  14732,  29268, -32284,  -5601 },
+    { -20787,  25329,  14009,  29621, -31785,  -7961 },
+    { -22004,  24278,  13278,  29955, -31113, -10278 },
+    { -23169,  23169,  12539,  30272, -30272, -12539 },
+    { -24278,  22004,  11792,  30571, -29268, -14732 },
+    { -25329,  20787,  11038,  30851, -28105, -16845 },
+    { -26318,  19519,  10278,  31113, -26789, -18867 },
+    { -27244,  18204,   9511,  31356, -25329, -20787 },
+    { -28105,  16845,   8739,  31580, -23731, -22594 },
+    { -28897,  15446,   7961,  31785, -22004, -24278 },
+    { -29621,  14009,   7179,  31970, -20159, -25831 },
+    { -30272,  12539,   6392,  32137, -18204, -27244 },
+    { -30851,  11038,   5601,  32284, -16150, -28510 },
+    { -31356,   9511,   4807,  32412, -14009, -29621 },
+    { -31785,   7961,   4011,  32520, -11792, -30571 },
+    { -32137,   6392,   3211,  32609,  -9511, -31356 },
+    { -32412,   4807,   2410,  32678,  -7179, -31970 },
+    { -32609,   3211,   1607,  32727,  -4807, -32412 },
+    { -32727,   1607,    804,  32757,  -2410, -32678 },
+    // Stage m = 1024
+    {  32767,      0,  32767,      0,  32767,      0 },
+    {  32764,    402,  32766,    201,  32761,    603 },
+    {  32757,    804,  32764,    402,  32744,   1206 },
+    {  32744,   1206,  32761,    603,  32717,   1808 },
+    {  32727,   1607,  32757,    804,  32678,   2410 },
+    {  32705,   2009,  32751,   1005,  32628,   3011 },
+    {  32678,   2410,  32744,   1206,  32567,   3611 },
+    {  32646,   2811,  32736,   1406,  32495,   4210 },
+    {  32609,   3211,  32727,   1607,  32412,   4807 },
+    {  32567,   3611,  32717,   1808,  32318,   5403 },
+    {  32520,   4011,  32705,   2009,  32213,   5997 },
+    {  32468,   4409,  32692,   2209,  32097,   6589 },
+    {  32412,   4807,  32678,   2410,  31970,   7179 },
+    {  32350,   5205,  32662,   2610,  31833,   7766 },
+    {  32284,   5601,  32646,   2811,  31684,   8351 },
+    {  32213,   5997,  32628,   3011,  31525,   8932 },
+    {  32137,   6392,  32609,   3211,  31356,   9511 },
+    {  32056,   6786,  32588,   3411,  31175,  10087 },
+    {  31970,   7179,  32567,   3611,  30984,  10659 },
+    {  31880,   7571,  32544,   3811,  30783,  11227 },
+    {  31785,   7961,  32520,   4011,  30571,  11792 },
+    {  31684,   8351,  32495,   4210,  30349,  12353 },
+    {  31580,   8739,  32468,   4409,  30116,  12909 },
+    {  31470,   9126,  32441,   4608,  29873,  13462 },
+    {  31356,   9511,  32412,   4807,  29621,  14009 },
+    {  31236,   9895,  32382,   5006,  29358,  14552 },
+    {  31113,  10278,  32350,   5205,  29085,  15090 },
+    {  30984,  10659,  32318,   5403,  28802,  15623 },
+    {  30851,  11038,  32284,   5601,  28510,  16150 },
+    {  30713,  11416,  32249,   5799,  28208,  16672 },
+    {  30571,  11792,  32213,   5997,  27896,  17189 },
+    {  30424,  12166,  32176,   6195,  27575,  17699 },
+    {  30272,  12539,  32137,   6392,  27244,  18204 },
+    {  30116,  12909,  32097,   6589,  26905,  18702 },
+    {  29955,  13278,  32056,   6786,  26556,  19194 },
+    {  29790,  13645,  32014,   6982,  26198,  19680 },
+    {  29621,  14009,  31970,   7179,  25831,  20159 },
+    {  29446,  14372,  31926,   7375,  25456,  20631 },
+    {  29268,  14732,  31880,   7571,  25072,  21096 },
+    {  29085,  15090,  31833,   7766,  24679,  21554 },
+    {  28897,  15446,  31785,   7961,  24278,  22004 },
+    {  28706,  15799,  31735,   8156,  23869,  22448 },
+    {  28510,  16150,  31684,   8351,  23452,  22883 },
+    {  28309,  16499,  31633,   8545,  23027,  23311 },
+    {  28105,  16845,  31580,   8739,  22594,  23731 },
+    {  27896,  17189,  31525,   8932,  22153,  24143 },
+    {  27683,  17530,  31470,   9126,  21705,  24546 },
+    {  27466,  17868,  31413,   9319,  21249,  24942 },
+    {  27244,  18204,  31356,   9511,  20787,  25329 },
+    {  27019,  18537,  31297,   9703,  20317,  25707 },
+    {  26789,  18867,  31236,   9895,  19840,  26077 },
+    {  26556,  19194,  31175,  10087,  19357,  26437 },
+    {  26318,  19519,  31113,  10278,  18867,  26789 },
+    {  26077,  19840,  31049,  10469,  18371,  27132 },
+    {  25831,  20159,  30984,  10659,  17868,  27466 },
+    {  25582,  20474,  30918,  10849,  17360,  27790 },
+    {  25329,  20787,  30851,  11038,  16845,  28105 },
+    {  25072,  21096,  30783,  11227,  16325,  28410 },
+    {  24811,  21402,  30713,  11416,  15799,  28706 },
+    {  24546,  21705,  30643,  11604,  15268,  28992 },
+    {  24278,  22004,  30571,  11792,  14732,  29268 },
+    {  24006,  22301,  30498,  11980,  14191,  29534 },
+    {  23731,  22594,  30424,  12166,  13645,  29790 },
+    {  23452,  22883,  30349,  12353,  13094,  30036 },
+    {  23169,  23169,  30272,  12539,  12539,  30272 },
+    {  22883,  23452,  30195,  12724,  11980,  30498 },
+    {  22594,  23731,  30116,  12909,  11416,  30713 },
+    {  22301,  24006,  30036,  13094,  10849,  30918 },
+    {  22004,  24278,  29955,  13278,  10278,  31113 },
+    {  21705,  24546,  29873,  13462,   9703,  31297 },
+    {  21402,  24811,  29790,  13645,   9126,  31470 },
+    {  21096,  25072,  29706,  13827,   8545,  31633 },
+    {  20787,  25329,  29621,  14009,   7961,  31785 },
+    {  20474,  25582,  29534,  14191,   7375,  31926 },
+    {  20159,  25831,  29446,  14372,   6786,  32056 },
+    {  19840,  26077,  29358,  14552,   6195,  32176 },
+    {  19519,  26318,  29268,  14732,   5601,  32284 },
+    {  19194,  26556,  29177,  14911,   5006,  32382 },
+    {  18867,  26789,  29085,  15090,   4409,  32468 },
+    {  18537,  27019,  28992,  15268,   3811,  32544 },
+    {  18204,  27244,  28897,  15446,   3211,  32609 },
+    {  17868,  27466,  28802,  15623,   2610,  32662 },
+    {  17530,  27683,  28706,  15799,   2009,  32705 },
+    {  17189,  27896,  28608,  15975,   1406,  32736 },
+    {  16845,  28105,  28510,  16150,    804,  32757 },
+    {  16499,  28309,  28410,  16325,    201,  32766 },
+    {  16150,  28510,  28309,  16499,   -402,  32764 },
+    {  15799,  28706,  28208,  16672,  -1005,  32751 },
+    {  15446,  28897,  28105,  16845,  -1607,  32727 },
+    {  15090,  29085,  28001,  17017,  -2209,  32692 },
+    {  14732,  29268,  27896,  17189,  -2811,  32646 },
+    {  14372,  29446,  27790,  17360,  -3411,  32588 },
+    {  14009,  29621,  27683,  17530,  -4011,  32520 },
+    {  13645,  29790,  27575,  17699,  -4608,  32441 },
+    {  13278,  29955,  27466,  17868,  -5205,  32350 },
+    {  12909,  30116,  27355,  18036,  -5799,  32249 },
+    {  12539,  30272,  27244,  18204,  -6392,  32137 },
+    {  12166,  30424,  27132,  18371,  -6982,  32014 },
+    {  11792,  30571,  27019,  18537,  -7571,  31880 },
+    {  11416,  30713,  26905,  18702,  -8156,  31735 },
+    {  11038,  30851,  26789,  18867,  -8739,  31580 },
+    {  10659,  30984,  26673,  19031,  -9319,  31413 },
+    {  10278,  31113,  26556,  19194,  -9895,  31236 },
+    {   9895,  31236,  26437,  19357, -10469,  31049 },
+    {   9511,  31356,  26318,  19519, -11038,  30851 },
+    {   9126,  31470,  26198,  19680, -11604,  30643 },
+    {   8739,  31580,  26077,  19840, -12166,  30424 },
+    {   8351,  31684,  25954,  20000, -12724,  30195 },
+    {   7961,  31785,  25831,  20159, -13278,  29955 },
+    {   7571,  31880,  25707,  20317, -13827,  29706 },
+    {   7179,  31970,  25582,  20474, -14372,  29446 },
+    {   6786,  32056,  25456,  20631, -14911,  29177 },
+    {   6392,  32137,  25329,  20787, -15446,  28897 },
+    {   5997,  32213,  25201,  20942, -15975,  28608 },
+    {   5601,  32284,  25072,  21096, -16499,  28309 },
+    {   5205,  32350,  24942,  21249, -17017,  28001 },
+    {   4807,  32412,  24811,  21402, -17530,  27683 },
+    {   4409,  32468,  24679,  21554, -18036,  27355 },
+    {   4011,  32520,  24546,  21705, -18537,  27019 },
+    {   3611,  32567,  24413,  21855, -19031,  26673 },
+    {   3211,  32609,  24278,  22004, -19519,  26318 },
+    {   2811,  32646,  24143,  22153, -20000,  25954 },
+    {   2410,  32678,  24006,  22301, -20474,  25582 },
+    {   2009,  32705,  23869,  22448, -20942,  25201 },
+    {   1607,  32727,  23731,  22594, -21402,  24811 },
+    {   1206,  32744,  23592,  22739, -21855,  24413 },
+    {    804,  32757,  23452,  22883, -22301,  24006 },
+    {    402,  32764,  23311,  23027, -22739,  23592 },
+    {      0,  32767,  23169,  23169, -23169,  23169 },
+    {   -402,  32764,  23027,  23311, -23592,  22739 },
+    {   -804,  32757,  22883,  23452, -24006,  22301 },
+    {  -1206,  32744,  22739,  23592, -24413,  21855 },
+    {  -1607,  32727,  22594,  23731, -24811,  21402 },
+    {  -2009,  32705,  22448,  23869, -25201,  20942 },
+    {  -2410,  32678,  22301,  24006, -25582,  20474 },
+    {  -2811,  32646,  22153,  24143, -25954,  20000 },
+    {  -3211,  32609,  22004,  24278, -26318,  19519 },
+    {  -3611,  32567,  21855,  24413, -26673,  19031 },
+    {  -4011,  32520,  21705,  24546, -27019,  18537 },
+    {  -4409,  32468,  21554,  24679, -27355,  18036 },
+    {  -4807,  32412,  21402,  24811, -27683,  17530 },
+    {  -5205,  32350,  21249,  24942, -28001,  17017 },
+    {  -5601,  32284,  21096,  25072, -28309,  16499 },
+    {  -5997,  32213,  20942,  25201, -28608,  15975 },
+    {  -6392,  32137,  20787,  25329, -28897,  15446 },
+    {  -6786,  32056,  20631,  25456, -29177,  14911 },
+    {  -7179,  31970,  20474,  25582, -29446,  14372 },
+    {  -7571,  31880,  20317,  25707, -29706,  13827 },
+    {  -7961,  31785,  20159,  25831, -29955,  13278 },
+    {  -8351,  31684,  20000,  25954, -30195,  12724 },
+    {  -8739,  31580,  19840,  26077, -30424,  12166 },
+    {  -9126,  31470,  19680,  26198, -30643,  11604 },
+    {  -9511,  31356,  19519,  26318, -30851,  11038 },
+    {  -9895,  31236,  19357,  26437, -31049,  10469 },
+    { -10278,  31113,  19194,  26556, -31236,   9895 },
+    { -10659,  30984,  19031,  26673, -31413,   9319 },
+    { -11038,  30851,  18867,  26789, -31580,   8739 },
+    { -11416,  30713,  18702,  26905, -31735,   8156 },
+    { -11792,  30571,  18537,  27019, -31880,   7571 },
+    { -12166,  30424,  18371,  27132, -32014,   6982 },
+    { -12539,  30272,  18204,  27244, -32137,   6392 },
+    { -12909,  30116,  18036,  27355, -32249,   5799 },
+    { -13278,  29955,  17868,  27466, -32350,   5205 },
+    { -13645,  29790,  17699,  27575, -32441,   4608 },
+    { -14009,  29621,  17530,  27683, -32520,   4011 },
+    { -14372,  29446,  17360,  27790, -32588,   3411 },
+    { -14732,  29268,  17189,  27896, -32646,   2811 },
+    { -15090,  29085,  17017,  28001, -32692,   2209 },
+    { -15446,  28897,  16845,  28105, -32727,   1607 },
+    { -15799,  28706,  16672,  28208, -32751,   1005 },
+    { -16150,  28510,  16499,  28309, -32764,    402 },
+    { -16499,  28309,  16325,  28410, -32766,   -201 },
+    { -16845,  28105,  16150,  28510, -32757,   -804 },
+    { -17189,  27896,  15975,  28608, -32736,  -1406 },
+    { -17530,  27683,  15799,  28706, -32705,  -2009 },
+    { -17868,  27466,  15623,  28802, -32662,  -2610 },
+    { -18204,  27244,  15446,  28897, -32609,  -3211 },
+    { -18537,  27019,  15268,  28992, -32544,  -3811 },
+    { -18867,  26789,  15090,  29085, -32468,  -4409 },
+    { -19194,  26556,  14911,  29177, -32382,  -5006 },
+    { -19519,  26318,  14732,  29268, -32284,  -5601 },
+    { -19840,  26077,  14552,  29358, -32176,  -6195 },
+    { -20159,  25831,  14372,  29446, -32056,  -6786 },
+    { -20474,  25582,  14191,  29534, -31926,  -7375 },
+    { -20787,  25329,  14009,  29621, -31785,  -7961 },
+    { -21096,  25072,  13827,  29706, -31633,  -8545 },
+    { -21402,  24811,  13645,  29790, -31470,  -9126 },
+    { -21705,  24546,  13462,  29873, -31297,  -9703 },
+    { -22004,  24278,  13278,  29955, -31113, -10278 },
+    { -22301,  24006,  13094,  30036, -30918, -10849 },
+    { -22594,  23731,  12909,  30116, -30713, -11416 },
+    { -22883,  23452,  12724,  30195, -30498, -11980 },
+    { -23169,  23169,  12539,  30272, -30272, -12539 },
+    { -23452,  22883,  12353,  30349, -30036, -13094 },
+    { -23731,  22594,  12166,  30424, -29790, -13645 },
+    { -24006,  22301,  11980,  30498, -29534, -14191 },
+    { -24278,  22004,  11792,  30571, -29268, -14732 },
+    { -24546,  21705,  11604,  30643, -28992, -15268 },
+    { -24811,  21402,  11416,  30713, -28706, -15799 },
+    { -25072,  21096,  11227,  30783, -28410, -16325 },
+    { -25329,  20787,  11038,  30851, -28105, -16845 },
+    { -25582,  20474,  10849,  30918, -27790, -17360 },
+    { -25831,  20159,  10659,  30984, -27466, -17868 },
+    { -26077,  19840,  10469,  31049, -27132, -18371 },
+    { -26318,  19519,  10278,  31113, -26789, -18867 },
+    { -26556,  19194,  10087,  31175, -26437, -19357 },
+    { -26789,  18867,   9895,  31236, -26077, -19840 },
+    { -27019,  18537,   9703,  31297, -25707, -20317 },
+    { -27244,  18204,   9511,  31356, -25329, -20787 },
+    { -27466,  17868,   9319,  31413, -24942, -21249 },
+    { -27683,  17530,   9126,  31470, -24546, -21705 },
+    { -27896,  17189,   8932,  31525, -24143, -22153 },
+    { -28105,  16845,   8739,  31580, -23731, -22594 },
+    { -28309,  16499,   8545,  31633, -23311, -23027 },
+    { -28510,  16150,   8351,  31684, -22883, -23452 },
+    { -28706,  15799,   8156,  31735, -22448, -23869 },
+    { -28897,  15446,   7961,  31785, -22004, -24278 },
+    { -29085,  15090,   7766,  31833, -21554, -24679 },
+    { -29268,  14732,   7571,  31880, -21096, -25072 },
+    { -29446,  14372,   7375,  31926, -20631, -25456 },
+    { -29621,  14009,   7179,  31970, -20159, -25831 },
+    { -29790,  13645,   6982,  32014, -19680, -26198 },
+    { -29955,  13278,   6786,  32056, -19194, -26556 },
+    { -30116,  12909,   6589,  32097, -18702, -26905 },
+    { -30272,  12539,   6392,  32137, -18204, -27244 },
+    { -30424,  12166,   6195,  32176, -17699, -27575 },
+    { -30571,  11792,   5997,  32213, -17189, -27896 },
+    { -30713,  11416,   5799,  32249, -16672, -28208 },
+    { -30851,  11038,   5601,  32284, -16150, -28510 },
+    { -30984,  10659,   5403,  32318, -15623, -28802 },
+    { -31113,  10278,   5205,  32350, -15090, -29085 },
+    { -31236,   9895,   5006,  32382, -14552, -29358 },
+    { -31356,   9511,   4807,  32412, -14009, -29621 },
+    { -31470,   9126,   4608,  32441, -13462, -29873 },
+    { -31580,   8739,   4409,  32468, -12909, -30116 },
+    { -31684,   8351,   4210,  32495, -12353, -30349 },
+    { -31785,   7961,   4011,  32520, -11792, -30571 },
+    { -31880,   7571,   3811,  32544, -11227, -30783 },
+    { -31970,   7179,   3611,  32567, -10659, -30984 },
+    { -32056,   6786,   3411,  32588, -10087, -31175 },
+    { -32137,   6392,   3211,  32609,  -9511, -31356 },
+    { -32213,   5997,   3011,  32628,  -8932, -31525 },
+    { -32284,   5601,   2811,  32646,  -8351, -31684 },
+    { -32350,   5205,   2610,  32662,  -7766, -31833 },
+    { -32412,   4807,   2410,  32678,  -7179, -31970 },
+    { -32468,   4409,   2209,  32692,  -6589, -32097 },
+    { -32520,   4011,   2009,  32705,  -5997, -32213 },
+    { -32567,   3611,   1808,  32717,  -5403, -32318 },
+    { -32609,   3211,   1607,  32727,  -4807, -32412 },
+    { -32646,   2811,   1406,  32736,  -4210, -32495 },
+    { -32678,   2410,   1206,  32744,  -3611, -32567 },
+    { -32705,   2009,   1005,  32751,  -3011, -32628 },
+    { -32727,   1607,    804,  32757,  -2410, -32678 },
+    { -32744,   1206,    603,  32761,  -1808, -32717 },
+    { -32757,    804,    402,  32764,  -1206, -32744 },
+    { -32764,    402,    201,  32766,   -603, -32761 },
+};
+
 __attribute__((always_inline))
 static inline void sum_dif(int16_t a, int16_t b,
                            int16_t *s, int16_t *d)
@@ -54,6 +589,52 @@ static inline void mult_shf(int16_t cos, int16_t sin, int16_t x, int16_t y,
     *v = (y * cos + x * sin) >> 15;
 }
 
+#ifdef _FFT_SIMD
+// Complex value is packed as (im << 16 | re), like FftSample in memory
+
+__attribute__((always_inline))
+static inline uint32_t load_cplx(const void *p)
+{
+    uint32_t ret;
+    memcpy(&ret, p, sizeof(ret));
+    return ret;
+}
+
+__attribute__((always_inline))
+static inline void store_cplx(void *p, uint32_t x)
+{
+    memcpy(p, &x, sizeof(x));
+}
+
+// Same as mult_shf() with twiddle w = (sin << 16 | cos)
+__attribute__((always_inline))
+static inline uint32_t mult_shf_cplx(uint32_t w, uint32_t x)
+{
+    int32_t u = (int32_t)__SMUSD(x, w) >> 15;
+    int32_t v = (int32_t)__SMUADX(x, w) >> 15;
+
+    return __PKHBT(u, v, 16);
+}
+
+// Radix-4 butterfly over packed values, x, y and v are already rotated
+__attribute__((always_inline))
+static inline void bfly4_cplx(FftSample *sp, int16_t i0, int16_t m4,
+                              uint32_t x, uint32_t y, uint32_t v)
+{
+    uint32_t a = load_cplx(&sp[i0]);
+
+    uint32_t s = __QADD16(a, x);
+    uint32_t u = __QSUB16(a, x);
+    uint32_t p = __QADD16(y, v);
+    uint32_t d = __QSUB16(y, v);
+
+    store_cplx(&sp[i0], __QADD16(s, p));
+    store_cplx(&sp[i0 + m4], __QASX(u, d));
+    store_cplx(&sp[i0 + 2 * m4], __QSUB16(s, p));
+    store_cplx(&sp[i0 + 3 * m4], __QSAX(u, d));
+}
+#endif
+
 int16_t fft_sin(int16_t phi)
 {
     return ((phi & (N_WAVE / 2)) ? -1 : 1) *
@@ -66,45 +647,123 @@ int16_t fft_cos(int16_t phi)
     return fft_sin(phi + N_WAVE / 4);
 }
 
-void fft_rev_bin(FftSample *sp)
+__attribute__((always_inline))
+static inline uint16_t fft_hamm(int16_t n)
 {
-    int16_t m, mr = 0;
-    int16_t tr, l;
-
-    for (m = 1; m < FFT_SIZE; m++) {
-        l = FFT_SIZE;
-        do {
-            l >>= 1;
-        } while (mr + l >= FFT_SIZE);
-
-        mr = (mr & (l - 1)) + l;
+    return hammTable[n < FFT_SIZE / 2 ? n : FFT_SIZE - 1 - n];
+}
 
-        if (mr <= m) {
-            continue;
+void fft_prepare(FftSample *sp, const int16_t *re, const int16_t *im, int16_t stride,
+                 int16_t dcRe, int16_t dcIm)
+{
+    for (int16_t k = 0; k < FFT_REV_PAIRS; k++) {
+        uint16_t i = revTable[k].i;
+        uint16_t j = revTable[k].j;
+
+        uint16_t hi = fft_hamm(i);
+        uint16_t hj = fft_hamm(j);
+
+        // Read both inputs first, so sp may overlap with them
+        int16_t ri = re[i * stride] - dcRe;
+        int16_t rj = re[j * stride] - dcRe;
+        int16_t ii = 0;
+        int16_t ij = 0;
+
+        if (im) {
+            ii = im[i * stride] - dcIm;
+            ij = im[j * stride] - dcIm;
         }
-        tr = sp[m].fr;
-        sp[m].fr = sp[mr].fr;
-        sp[mr].fr = tr;
+
+        sp[i].fr = (hj * rj) >> 16;
+        sp[i].fi = (hj * ij) >> 16;
+        sp[j].fr = (hi * ri) >> 16;
+        sp[j].fi = (hi * ii) >> 16;
     }
 }
 
-void fft_hamm_window(FftSample *sp)
+#ifdef _FFT_SIMD
+__attribute__((always_inline))
+static inline void fft_bfly4(FftSample *sp, int16_t i0, int16_t m4, const FftTwiddle *tw)
+{
+    uint32_t x = mult_shf_cplx(load_cplx(&tw->cos2), load_cplx(&sp[i0 + m4]));
+    uint32_t y = mult_shf_cplx(load_cplx(&tw->cos1), load_cplx(&sp[i0 + 2 * m4]));
+    uint32_t v = mult_shf_cplx(load_cplx(&tw->cos3), load_cplx(&sp[i0 + 3 * m4]));
+
+    bfly4_cplx(sp, i0, m4, x, y, v);
+}
+#else
+__attribute__((always_inline))
+static inline void fft_bfly4(FftSample *sp, int16_t i0, int16_t m4, const FftTwiddle *tw)
 {
-    for (int16_t i = 0; i < FFT_SIZE / 2; i++) {
+    int16_t i1 = i0 + m4;
+    int16_t i2 = i1 + m4;
+    int16_t i3 = i2 + m4;
+
+    int16_t xr, yr, ur, vr, xi, yi, ui, vi;
+    int16_t t;
+
+    mult_shf(tw->cos2, tw->sin2, sp[i1].fr, sp[i1].fi, &xr, &xi);
+    mult_shf(tw->cos1, tw->sin1, sp[i2].fr, sp[i2].fi, &yr, &vr);
+    mult_shf(tw->cos3, tw->sin3, sp[i3].fr, sp[i3].fi, &vi, &yi);
+
+    t = yi - vr;
+    yi += vr;
+    vr = t;
+
+    ur = sp[i0].fr - xr;
+    xr += sp[i0].fr;
+
+    sum_dif(ur, vr, &sp[i1].fr, &sp[i3].fr);
+
+    t = yr - vi;
+    yr += vi;
+    vi = t;
+
+    ui = sp[i0].fi - xi;
+    xi += sp[i0].fi;
+
+    sum_dif(ui, vi, &sp[i1].fi, &sp[i3].fi);
+    sum_dif(xr, yr, &sp[i0].fr, &sp[i2].fr);
+    sum_dif(xi, yi, &sp[i0].fi, &sp[i2].fi);
+}
+#endif
+
+// Shift the block right until it has enough headroom for the next stage
+static int8_t fft_bfp_scale(FftSample *sp)
+{
+    uint16_t bits = 0;
+    int8_t shift = 0;
+
+    for (int16_t i = 0; i < FFT_SIZE; i++) {
+        bits |= (uint16_t)(sp[i].fr ^ (sp[i].fr >> 15));
+        bits |= (uint16_t)(sp[i].fi ^ (sp[i].fi >> 15));
+    }
 
-        // Use Hamm coefficients 0.53836 and 0.46164 scaled by SIN_SCALE = 2^15
-        uint16_t ht = (uint16_t)(35281 - ((30253 * fft_cos(i * (N_HANN / FFT_SIZE))) >> 15));
+    while ((bits >> shift) >= FFT_BFP_LIMIT) {
+        shift++;
+    }
 
-        sp[i].fr = (ht * sp[i].fr) >> 16;
-        sp[FFT_SIZE - 1 - i].fr = (ht * sp[FFT_SIZE - 1 - i].fr) >> 16;
+    if (shift) {
+        for (int16_t i = 0; i < FFT_SIZE; i++) {
+            sp[i].fr >>= shift;
+            sp[i].fi >>= shift;
+        }
     }
+
+    return shift;
 }
 
-void fft_radix4(FftSample *sp)
+int8_t fft_radix4_bfp(FftSample *sp)
 {
     int16_t ldm = 0, rdx = 2;
+    int8_t exp = fft_bfp_scale(sp);
 
+    // First stage, all twiddles are 1
     for (int16_t i0 = 0; i0 < FFT_SIZE; i0 += 4) {
+#ifdef _FFT_SIMD
+        bfly4_cplx(sp, i0, 1, load_cplx(&sp[i0 + 1]), load_cplx(&sp[i0 + 2]),
+                   load_cplx(&sp[i0 + 3]));
+#else
         int16_t i1 = i0 + 1;
         int16_t i2 = i1 + 1;
         int16_t i3 = i2 + 1;
@@ -120,61 +779,62 @@ void fft_radix4(FftSample *sp)
         sum_dif(xi, yi, &sp[i0].fi, &sp[i2].fi);
         sum_dif(ur, vr, &sp[i1].fr, &sp[i3].fr);
         sum_dif(xr, yr, &sp[i0].fr, &sp[i2].fr);
+#endif
     }
 
-    for (ldm = 2 * rdx; ldm <= FFT_LOG2; ldm += rdx) {
+    const FftTwiddle *tw = twiddle;
+
+    // Middle stages
+    for (ldm = 2 * rdx; ldm < FFT_LOG2; ldm += rdx) {
         int16_t m = (1 << ldm);
         int16_t m4 = (m >> rdx);
 
-        int16_t phi0 =  N_WAVE / m;
-        int16_t phi  = 0;
+        exp += fft_bfp_scale(sp);
 
-        for (int16_t i = 0; i < m4; i++) {
-            int16_t sin1, sin2, sin3;
-            int16_t cos1, cos2, cos3;
-
-            sin1 = fft_sin(1 * phi);
-            sin2 = fft_sin(2 * phi);
-            sin3 = fft_sin(3 * phi);
+        for (int16_t i = 0; i < m4; i++, tw++) {
+            for (int16_t r = 0; r < FFT_SIZE; r += m) {
+                fft_bfly4(sp, i + r, m4, tw);
+            }
+        }
+    }
 
-            cos1 = fft_cos(1 * phi);
-            cos2 = fft_cos(2 * phi);
-            cos3 = fft_cos(3 * phi);
+    // Last stage, a single group over the whole buffer
+    exp += fft_bfp_scale(sp);
 
-            for (int16_t r = 0; r < FFT_SIZE; r += m) {
-                int16_t i0 = i + r;
-                int16_t i1 = i0 + m4;
-                int16_t i2 = i1 + m4;
-                int16_t i3 = i2 + m4;
+    for (int16_t i = 0; i < FFT_SIZE / 4; i++, tw++) {
+        fft_bfly4(sp, i, FFT_SIZE / 4, tw);
+    }
 
-                int16_t xr, yr, ur, vr, xi, yi, ui, vi;
-                int16_t t;
+    return exp;
+}
 
-                mult_shf(cos2, sin2, sp[i1].fr, sp[i1].fi, &xr, &xi);
-                mult_shf(cos1, sin1, sp[i2].fr, sp[i2].fi, &yr, &vr);
-                mult_shf(cos3, sin3, sp[i3].fr, sp[i3].fi, &vi, &yi);
+void fft_split(FftSample *sp)
+{
+    FftSample t;
 
-                t = yi - vr;
-                yi += vr;
-                vr = t;
+    // Z[k] = L[k] + j * R[k], where L and R are spectrums of the real signals
+    // L[k] = (Z[k] + Z*[N - k]) / 2, R[k] = (Z[k] - Z*[N - k]) / 2j
 
-                ur = sp[i0].fr - xr;
-                xr += sp[i0].fr;
+    // Nyquist bin is not used, its place is taken by R[0]
+    sp[FFT_SIZE / 2].fr = sp[0].fi;
+    sp[FFT_SIZE / 2].fi = 0;
+    sp[0].fi = 0;
 
-                sum_dif(ur, vr, &sp[i1].fr, &sp[i3].fr);
+    for (int16_t k = 1; k < FFT_SIZE / 2; k++) {
+        FftSample a = sp[k];
+        FftSample b = sp[FFT_SIZE - k];
 
-                t = yr - vi;
-                yr += vi;
-                vi = t;
+        sp[k].fr = (a.fr + b.fr) >> 1;
+        sp[k].fi = (a.fi - b.fi) >> 1;
 
-                ui = sp[i0].fi - xi;
-                xi += sp[i0].fi;
+        sp[FFT_SIZE - k].fr = (a.fi + b.fi) >> 1;
+        sp[FFT_SIZE - k].fi = (b.fr - a.fr) >> 1;
+    }
 
-                sum_dif(ui, vi, &sp[i1].fi, &sp[i3].fi);
-                sum_dif(xr, yr, &sp[i0].fr, &sp[i2].fr);
-                sum_dif(xi, yi, &sp[i0].fi, &sp[i2].fi);
-            }
-            phi += phi0;
-        }
+    // R[k] is stored at N - k, reorder it to N / 2 + k
+    for (int16_t i = FFT_SIZE / 2 + 1, j = FFT_SIZE - 1; i < j; i++, j--) {
+        t = sp[i];
+        sp[i] = sp[j];
+        sp[j] = t;
     }
 }
@@ -20,9 +20,19 @@ typedef struct {
 int16_t fft_sin(int16_t phi);
 int16_t fft_cos(int16_t phi);
 
-void fft_rev_bin(FftSample *sp);
-void fft_hamm_window(FftSample *sp);
-void fft_radix4(FftSample *sp);
+// Remove DC, apply window and put samples in bit-reversed order in a single pass.
+// Input is read from re/im with given stride (in int16_t), im may be NULL for real data.
+// Output may overlap with the input.
+void fft_prepare(FftSample *sp, const int16_t *re, const int16_t *im, int16_t stride,
+                 int16_t dcRe, int16_t dcIm);
+
+// Block floating point FFT: the block is scaled down only when a stage
+// may overflow. Returns exponent, result must be multiplied by 2^exp
+int8_t fft_radix4_bfp(FftSample *sp);
+
+// Split spectrum of two real signals packed to fr and fi:
+// sp[0..N/2) gets spectrum of fr, sp[N/2..N) gets spectrum of fi
+void fft_split(FftSample *sp);
 
 #ifdef __cplusplus
 }
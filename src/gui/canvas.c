@@ -5,6 +5,8 @@
 
 #include "amp.h"
 #include "bt.h"
+#include "display/dispdrv.h"
+#include "events.h"
 #include "mpc.h"
 #include "menu.h"
 #include "rtc.h"
@@ -20,6 +22,23 @@
 
 #define SPECTRUM_SIZE   128
 
+#define SP_WINDOW_COST  8       // Bus bytes to set up a window, address is often cached
+#define SP_LINE_SIZE    64      // Pixels collected before streaming
+#define SP_GROUP_COLS   4       // Columns streamed together as a part of the frame
+#define SP_GRAD_SIZE    512     // Colors of all cached gradients
+#define SP_GRAD_NUM     2       // Gradients used by one spectrum view
+
+// Waterfall lines kept to repaint the screen, F103 has no RAM left for them
+#ifndef SP_WTF_LINES
+#if defined(_F303CC)
+#define SP_WTF_LINES    64
+#elif defined(_F303CB)
+#define SP_WTF_LINES    32
+#else
+#define SP_WTF_LINES    0
+#endif
+#endif
+
 typedef union {
     RTC_type rtc;
     int16_t wtfX;
@@ -35,39 +54,97 @@ typedef union {
     int timer;
 } DrawData;
 
+// Column states are kept as arrays to update all columns of a frame by words
 typedef union {
     struct {
-        uint8_t show[SP_CHAN_END];   // Value to show
-        uint8_t prev[SP_CHAN_END];   // Previous value
-        uint8_t peak[SP_CHAN_END];   // Peak value
-        uint8_t fall[SP_CHAN_END];   // Fall speed
-    };
-    SpectrumColumn col;
-} SpCol;
-
-typedef struct {
-    SpCol col[SPECTRUM_SIZE];
+        uint8_t show[SP_CHAN_END][SPECTRUM_SIZE];   // Value to show
+        uint8_t prev[SP_CHAN_END][SPECTRUM_SIZE];   // Previous value
+        uint8_t peak[SP_CHAN_END][SPECTRUM_SIZE];   // Peak value
+        uint8_t fall[SP_CHAN_END][SPECTRUM_SIZE];   // Fall speed
+    } chan;
+    struct {
+        uint16_t show[SPECTRUM_SIZE];               // Mixed channels may be higher than 255
+        uint16_t prev[SPECTRUM_SIZE];
+        uint16_t peak[SPECTRUM_SIZE];
+        uint16_t fall[SPECTRUM_SIZE];
+    } both;
 } SpDrawData;
 
 typedef struct {
     uint8_t raw[SPECTRUM_SIZE];
 } SpData;
 
+typedef struct {
+    int16_t colMin;
+    int16_t colMax;
+    int16_t rowMin;
+    int16_t rowMax;
+    int32_t colCost;            // Bus bytes to draw changes column by column
+} SpArea;
+
+typedef struct {
+    int16_t step;               // Columns geometry
+    int16_t colW;
+    int16_t height;
+    SpChan chan;
+    bool mirror;
+    bool peaks;
+    const color_t *grad;
+
+    SpArea frame;               // Changed area of all columns
+    SpArea group[SPECTRUM_SIZE / SP_GROUP_COLS];
+    uint8_t changed[SPECTRUM_SIZE / 8];
+
+    int16_t loaded;             // Column cached for streaming
+    SpectrumColumn spCol;
+    int16_t len;
+    color_t buf[SP_LINE_SIZE];
+} SpFrame;
+
+typedef struct {
+    const Palette *pal;
+    int16_t height;             // 0 if gradient is not cached
+    int16_t oft;                // Position in the cache
+    bool mirror;
+    bool grad;
+} SpGrad;
+
+typedef struct {
+    SpGrad item[SP_GRAD_NUM];
+    color_t color[SP_GRAD_SIZE];
+} SpGradCache;
+
+typedef struct {
+    int16_t height;             // Rows the map is built for
+    uint8_t size;               // Columns the map and history are built for
+    SpScale scale;
+    uint8_t head;               // History line to write next
+    uint8_t count;              // History lines stored
+    int16_t pos[SPECTRUM_SIZE + 1]; // First row of each column, from the bottom
+#if SP_WTF_LINES > 0
+    uint8_t line[SP_WTF_LINES][SPECTRUM_SIZE];
+#endif
+} SpWtf;
 
 static void drawMenuItem(uint8_t idx, const tFont *fontItem);
-static void calcSpCol(int16_t chan, int16_t scale, uint8_t col, SpectrumColumn *spCol,
-                      SpData *spData);
+static void calcSpFrame(int16_t chan, int16_t scale, int16_t num, SpData *spData);
 static void drawWaterfall(bool clear);
-static void drawSpectrum(bool clear, bool mirror, SpChan chan, GlcdRect *rect);
+static void drawSpectrum(bool clear, bool mirror, SpChan chan, GlcdRect *rect,
+                         SpData *spData);
 static void drawSpectrumMode(bool clear, GlcdRect rect);
 static void drawRds(RdsParser *rds);
 static bool checkSpectrumReady(void);
-static void fftGet128(FftSample *sp, uint8_t *out, size_t size);
+static void checkBinMap(uint8_t cols);
+static void fftGetColumns(FftSample *sp, int8_t exp, uint8_t *out, size_t size);
 
 static Canvas canvas;
 static SpDrawData spDrawData;
+static SpGradCache spGradCache;
+static SpWtf spWtf;
 static DrawData prev;
 static ScrollText scroll;
+static SpBinMap binMap;
+static uint8_t binMapCols;
 
 static const tImage *glcdFindIcon(Icon code, const tFont *iFont)
 {
@@ -89,19 +166,50 @@ static const tImage *glcdFindIcon(Icon code, const tFont *iFont)
     return  ret;
 }
 
+// Cross of two thick diagonals with background outline, drawn once by row spans
 static void drawCrosssing(int16_t x, int16_t y, int16_t w)
 {
     const Palette *pal = paletteGet();
 
-    int8_t th = w / 20 + 1;
+    int16_t th = w / 20 + 1;
+
+    for (int16_t row = 0; row < w; row++) {
+        int16_t d0 = row;
+        int16_t d1 = w - 1 - row;
+        int16_t c0 = (d0 < d1 ? d0 : d1) - th;
+        int16_t c1 = (d0 > d1 ? d0 : d1) + th;
+
+        if (c0 < 0) {
+            c0 = 0;
+        }
+        if (c1 > w - 1) {
+            c1 = w - 1;
+        }
+
+        int16_t start = c0;
+        int8_t type = 0;
 
-    for (int8_t i = 0; i <= th; i++) {
-        color_t color = (i >= th ? pal->bg : pal->fg);
-        glcdDrawLine(x + i, y, x + w - 1, y + w - 1 - i, color);
-        glcdDrawLine(x, y + i, x + w - 1 - i, y + w - 1, color);
+        for (int16_t col = c0; col <= c1 + 1; col++) {
+            int16_t a = col > d0 ? col - d0 : d0 - col;
+            int16_t b = col > d1 ? col - d1 : d1 - col;
+            int8_t next = 0;
 
-        glcdDrawLine(x + i, y + w - 1, x + w - 1, y + i, color);
-        glcdDrawLine(x, y + w - 1 - i, x + w - 1 - i, y, color);
+            if (col > c1) {
+                next = 0;
+            } else if (a == th || b == th) {
+                next = 2;
+            } else if (a < th || b < th) {
+                next = 1;
+            }
+
+            if (next != type) {
+                if (type) {
+                    glcdDrawRect(x + start, y + row, col - start, 1, type == 1 ? pal->fg : pal->bg);
+                }
+                start = col;
+                type = next;
+            }
+        }
     }
 }
 
@@ -242,62 +350,45 @@ static void drawMenuItem(uint8_t idx, const tFont *fontItem)
     glcdDrawRect(x, y_pos + 2, width - 2 - x - strLen, fIh, canvas.pal->bg);
 }
 
-static void calcSpCol(int16_t chan, int16_t scale, uint8_t col, SpectrumColumn *spCol,
-                      SpData *spData)
+static void loadSpCol(int16_t chan, uint8_t col, SpectrumColumn *spCol)
 {
-    int16_t raw;
-
-    SpCol *spDrawCol = &spDrawData.col[col];
-
     if (chan == SP_CHAN_BOTH) {
-        uint8_t rawL = spData[SP_CHAN_LEFT].raw[col];
-        uint8_t rawR = spData[SP_CHAN_RIGHT].raw[col];
-        if (rawL > rawR) {
-            raw = rawL;
-        } else {
-            raw = rawR;
-        }
-        *spCol = spDrawCol->col;
+        spCol->showW = (int16_t)spDrawData.both.show[col];
+        spCol->prevW = (int16_t)spDrawData.both.prev[col];
+        spCol->peakW = (int16_t)spDrawData.both.peak[col];
+        spCol->fallW = (int16_t)spDrawData.both.fall[col];
     } else {
-        raw = spData[chan].raw[col];
-        spCol->showW = spDrawCol->show[chan];
-        spCol->prevW = spDrawCol->prev[chan];
-        spCol->peakW = spDrawCol->peak[chan];
-        spCol->fallW = spDrawCol->fall[chan];
+        spCol->showW = spDrawData.chan.show[chan][col];
+        spCol->prevW = spDrawData.chan.prev[chan][col];
+        spCol->peakW = spDrawData.chan.peak[chan][col];
+        spCol->fallW = spDrawData.chan.fall[chan][col];
     }
+}
 
-    raw = (scale * raw) >> 8; // / N_DB = 256
+static void calcSpFrame(int16_t chan, int16_t scale, int16_t num, SpData *spData)
+{
+    if (chan == SP_CHAN_BOTH) {
+        uint16_t raw[SPECTRUM_SIZE];
 
-    spCol->prevW = spCol->showW;
-    if (raw < spCol->showW) {
-        if (spCol->showW >= spCol->fallW) {
-            spCol->showW -= spCol->fallW;
-            spCol->fallW++;
-        } else {
-            spCol->showW = 0;
+        for (int16_t col = 0; col < num; col++) {
+            uint8_t rawL = spData[SP_CHAN_LEFT].raw[col];
+            uint8_t rawR = spData[SP_CHAN_RIGHT].raw[col];
+            raw[col] = (uint16_t)((scale * (rawL > rawR ? rawL : rawR)) >> 8); // / N_DB = 256
         }
-    }
-
-    if (raw > spCol->showW) {
-        spCol->showW = raw;
-        spCol->fallW = 1;
-    }
+        memset(&raw[num], 0, sizeof (raw) - (size_t)num * sizeof (raw[0]));
 
-    if (spCol->peakW <= raw) {
-        spCol->peakW = raw + 1;
+        spectrumColumnCalc16(spDrawData.both.show, spDrawData.both.prev, spDrawData.both.peak,
+                             spDrawData.both.fall, raw, num);
     } else {
-        if (spCol->peakW && spCol->peakW > spCol->showW + 1) {
-            spCol->peakW--;
+        uint8_t raw[SPECTRUM_SIZE];
+
+        for (int16_t col = 0; col < num; col++) {
+            raw[col] = (uint8_t)((scale * spData[chan].raw[col]) >> 8); // / N_DB = 256
         }
-    }
+        memset(&raw[num], 0, sizeof (raw) - (size_t)num * sizeof (raw[0]));
 
-    if (chan == SP_CHAN_BOTH) {
-        spDrawCol->col = *spCol;
-    } else {
-        spDrawCol->show[chan] = (uint8_t)spCol->showW;
-        spDrawCol->prev[chan] = (uint8_t)spCol->prevW;
-        spDrawCol->peak[chan] = (uint8_t)spCol->peakW;
-        spDrawCol->fall[chan] = (uint8_t)spCol->fallW;
+        spectrumColumnCalc8(spDrawData.chan.show[chan], spDrawData.chan.prev[chan],
+                            spDrawData.chan.peak[chan], spDrawData.chan.fall[chan], raw, num);
     }
 }
 
@@ -331,40 +422,121 @@ static color_t getRainbowColor(uint8_t value)
     return color;
 }
 
+static void checkWtfMap(int16_t height)
+{
+    SpWtf *wtf = &spWtf;
+    Spectrum *sp = spGet();
+
+    if (wtf->size != binMap.size || wtf->scale != sp->scale) {
+        wtf->size = binMap.size;
+        wtf->scale = sp->scale;
+        wtf->height = 0;
+        wtf->count = 0;
+    }
+
+    if (wtf->height != height) {
+        for (int16_t col = 0; col <= wtf->size; col++) {
+            wtf->pos[col] = (int16_t)((col * height) / wtf->size);
+        }
+        wtf->height = height;
+    }
+}
+
+static void drawWaterfallLine(int16_t x, const uint8_t *line)
+{
+    SpWtf *wtf = &spWtf;
+    const int16_t h = wtf->height;
+
+    if (!glcdStreamBegin(x, 0, 1, h)) {
+        for (int16_t col = 0; col < wtf->size; col++) {
+            int16_t wfH = wtf->pos[col + 1] - wtf->pos[col];
+            glcdDrawRect(x, h - wtf->pos[col] - wfH, 1, wfH, getRainbowColor(line[col]));
+        }
+        return;
+    }
+
+    color_t buf[SP_LINE_SIZE];
+    int16_t len = 0;
+
+    // Top row is the last column
+    for (int16_t col = wtf->size - 1; col >= 0; col--) {
+        color_t color = getRainbowColor(line[col]);
+
+        for (int16_t i = wtf->pos[col + 1] - wtf->pos[col]; i > 0; i--) {
+            buf[len++] = color;
+            if (len >= SP_LINE_SIZE) {
+                glcdStreamColors(buf, len);
+                len = 0;
+            }
+        }
+    }
+
+    if (len) {
+        glcdStreamColors(buf, len);
+    }
+    glcdStreamEnd();
+}
+
 static void drawWaterfall(bool clear)
 {
+    const Layout *lt = canvas.layout;
+    SpWtf *wtf = &spWtf;
+
+    checkBinMap(SPECTRUM_SIZE);
+    checkWtfMap(lt->rect.h);
+
+    if (clear) {
+        // Repaint stored lines instead of starting blank
+        int16_t count = wtf->count < lt->rect.w ? wtf->count : lt->rect.w - 1;
+
+#if SP_WTF_LINES > 0
+        for (int16_t i = 0; i < count; i++) {
+            int16_t idx = (wtf->head + SP_WTF_LINES - count + i) % SP_WTF_LINES;
+            drawWaterfallLine(i, wtf->line[idx]);
+        }
+#endif
+        prev.wtfX = count - 1;
+        glcdShift(count % lt->rect.w);
+    }
+
     if (!checkSpectrumReady()) {
         return;
     }
 
     SpData spData[SP_CHAN_END];
 
-    spGetADC(SP_CHAN_LEFT, spData[SP_CHAN_LEFT].raw, SPECTRUM_SIZE, fftGet128);
-    spGetADC(SP_CHAN_RIGHT, spData[SP_CHAN_RIGHT].raw, SPECTRUM_SIZE, fftGet128);
-
-    const Layout *lt = canvas.layout;
+    if (!spGetADC(SP_CHAN_BOTH, spData[SP_CHAN_LEFT].raw, SPECTRUM_SIZE, fftGetColumns)) {
+        return;
+    }
 
-    if (clear || ++prev.wtfX >= lt->rect.w) {
+    if (++prev.wtfX >= lt->rect.w) {
         prev.wtfX = 0;
     }
     glcdShift((prev.wtfX + 1) % lt->rect.w);
 
-    for (uint8_t col = 0; col < SPECTRUM_SIZE; col++) {
-        SpectrumColumn spCol;
-        calcSpCol(SP_CHAN_BOTH, 224, col, &spCol, spData);
-        color_t color = getRainbowColor((uint8_t)spCol.showW);
+#if SP_WTF_LINES > 0
+    uint8_t *line = wtf->line[wtf->head];
+#else
+    // Raw data is not needed after calcSpFrame()
+    uint8_t *line = spData[SP_CHAN_LEFT].raw;
+#endif
 
-        int16_t posCurr = (col * lt->rect.h) / SPECTRUM_SIZE;
-        int16_t posNext = ((col + 1) * lt->rect.h) / SPECTRUM_SIZE;
+    calcSpFrame(SP_CHAN_BOTH, 224, wtf->size, spData);
+    for (uint8_t col = 0; col < wtf->size; col++) {
+        line[col] = (uint8_t)spDrawData.both.show[col];
+    }
 
-        int16_t wfH = (posNext - posCurr);
-        if (wfH) {
-            glcdDrawRect(prev.wtfX, lt->rect.h - posCurr - wfH, 1, wfH, color);
-        }
+    drawWaterfallLine(prev.wtfX, line);
+
+#if SP_WTF_LINES > 0
+    wtf->head = (wtf->head + 1) % SP_WTF_LINES;
+    if (wtf->count < SP_WTF_LINES) {
+        wtf->count++;
     }
+#endif
 }
 
-static void calcGradient(Spectrum *sp, int16_t height, bool mirror, color_t *grad)
+static void calcGradient(bool gradient, int16_t height, bool mirror, color_t *grad)
 {
     color_t colorB = mirror ? canvas.pal->spColG : canvas.pal->spColB;
     color_t colorG = mirror ? canvas.pal->spColB : canvas.pal->spColG;
@@ -378,7 +550,7 @@ static void calcGradient(Spectrum *sp, int16_t height, bool mirror, color_t *gra
     color_t bG = (colorG & 0x001F) >> 0;
 
     for (int16_t i = 0; i < height; i++) {
-        if (sp->flags & SP_FLAG_GRAD) {
+        if (gradient) {
             grad[i] = (color_t)(((rB + (rG - rB) * i / (height - 1)) << 11) |
                                 ((gB + (gG - gB) * i / (height - 1)) << 5) |
                                 ((bB + (bG - bB) * i / (height - 1)) << 0));
@@ -388,65 +560,305 @@ static void calcGradient(Spectrum *sp, int16_t height, bool mirror, color_t *gra
     }
 }
 
-static bool checkSpectrumReady(void)
+// Palette and height change only with the screen, so gradients are calculated once
+static color_t *getGradient(Spectrum *sp, int16_t height, bool mirror)
 {
-    if (swTimGet(SW_TIM_SP_CONVERT) == 0) {
-        swTimSet(SW_TIM_SP_CONVERT, 25);
-        return true;
+    SpGradCache *cache = &spGradCache;
+    bool gradient = (sp->flags & SP_FLAG_GRAD);
+    int16_t end = 0;
+    SpGrad *slot = NULL;
+
+    for (int16_t i = 0; i < SP_GRAD_NUM; i++) {
+        SpGrad *item = &cache->item[i];
+
+        if (item->height == 0) {
+            if (slot == NULL) {
+                slot = item;
+            }
+            continue;
+        }
+        if (item->pal == canvas.pal && item->height == height &&
+            item->mirror == mirror && item->grad == gradient) {
+            return &cache->color[item->oft];
+        }
+        if (end < item->oft + item->height) {
+            end = item->oft + item->height;
+        }
     }
 
-    return false;
+    // Start over if there is no room for the new gradient
+    if (slot == NULL || end + height > SP_GRAD_SIZE) {
+        memset(cache->item, 0, sizeof (cache->item));
+        slot = &cache->item[0];
+        end = 0;
+    }
+
+    slot->pal = canvas.pal;
+    slot->height = height;
+    slot->oft = end;
+    slot->mirror = mirror;
+    slot->grad = gradient;
+
+    calcGradient(gradient, height, mirror, &cache->color[end]);
+
+    return &cache->color[end];
 }
 
-static void fftGet128(FftSample *sp, uint8_t *out, size_t size)
+static bool checkSpectrumReady(void)
 {
-    uint8_t db;
-    uint8_t *po = out;
+    // Redraw when a new ADC block is completed
+    return swTimGet(SW_TIM_SP_CONVERT) != SW_TIM_OFF && spIsReady();
+}
 
-    memset(po, 0, size);
+static int16_t getSpectrumCols(int16_t width)
+{
+    const int16_t step = (width + 1) / SPECTRUM_SIZE + 1;
+    const int16_t colW = step - (step / 2);
 
-    for (int16_t i = 0; i < FFT_SIZE / 2; i++) {
-        uint16_t calc = (uint16_t)((sp[i].fr * sp[i].fr + sp[i].fi * sp[i].fi) >> 15);
+    return (width + colW - 1) / step;
+}
 
-        db = spGetDb(calc);
+static void checkBinMap(uint8_t cols)
+{
+    Spectrum *sp = spGet();
 
-        if (*po < db) {
-            *po = db;
-        }
+    if (cols > SPECTRUM_SIZE) {
+        cols = SPECTRUM_SIZE;
+    }
 
-        if ((i < 48) ||
-            ((i < 96) && (i & 0x01) == 0x01) ||
-            ((i < 192) && (i & 0x03) == 0x03) ||
-            ((i < 384) && (i & 0x07) == 0x07) ||
-            ((i & 0x0F) == 0x0F)) {
-            po++;
+    // Rebuild only when layout or scale changes
+    if (binMapCols != cols || binMap.scale != sp->scale) {
+        spBuildBinMap(&binMap, sp->scale, cols);
+        binMapCols = cols;
+    }
+}
 
-            if (--size == 0) {
-                break;
+static void fftGetColumns(FftSample *sp, int8_t exp, uint8_t *out, size_t size)
+{
+    Spectrum *spc = spGet();
+
+    // dB table is made for 10-bit input power scaled by 2^-15
+    int8_t shift = 2 * exp - 4 - 15;
+
+    memset(out, 0, size);
+
+    for (uint8_t col = 0; col < binMap.size && col < size; col++) {
+        uint32_t pwr = 0;
+        uint16_t i = binMap.start[col];
+        uint16_t end = binMap.start[col + 1];
+
+        if (spc->flags & SP_FLAG_SUM) {
+            for (; i < end; i++) {
+                uint32_t bin = (uint32_t)(sp[i].fr * sp[i].fr) + (uint32_t)(sp[i].fi * sp[i].fi);
+                pwr = (pwr + bin < pwr) ? UINT32_MAX : pwr + bin;
+            }
+        } else {
+            for (; i < end; i++) {
+                uint32_t bin = (uint32_t)(sp[i].fr * sp[i].fr) + (uint32_t)(sp[i].fi * sp[i].fi);
+                if (pwr < bin) {
+                    pwr = bin;
+                }
             }
         }
+
+        if (shift < 0) {
+            pwr >>= -shift;
+        } else if (pwr > (UINT16_MAX >> shift)) {
+            pwr = UINT16_MAX;
+        } else {
+            pwr <<= shift;
+        }
+
+        out[col] = spGetDb((uint16_t)(pwr > UINT16_MAX ? UINT16_MAX : pwr));
     }
 }
 
-static void drawSpectrum(bool clear, bool mirror, SpChan chan, GlcdRect *rect)
+// On screen values, as spectrumColumnDraw() limits them
+static void clampSpCol(SpectrumColumn *spCol, int16_t height, bool peaks)
 {
-    SpData spData[SP_CHAN_END];
+    if (spCol->showW == 0) {
+        spCol->showW = 1;
+    }
+    if (spCol->showW >= height) {
+        spCol->showW = height - 1;
+    }
+    if (spCol->prevW == 0) {
+        spCol->prevW = 1;
+    }
+    if (spCol->prevW >= height) {
+        spCol->prevW = height - 1;
+    }
+    if (!peaks) {
+        spCol->peakW = 0;
+    }
+    if (spCol->peakW >= height) {
+        spCol->peakW = height - 1;
+    }
+}
+
+static void spAreaAdd(SpArea *area, int16_t col, int16_t rowMin, int16_t rowMax)
+{
+    if (area->colMin > col) {
+        area->colMin = col;
+    }
+    if (area->colMax < col) {
+        area->colMax = col;
+    }
+    if (area->rowMin > rowMin) {
+        area->rowMin = rowMin;
+    }
+    if (area->rowMax < rowMax) {
+        area->rowMax = rowMax;
+    }
+}
+
+static int32_t spAreaStreamCost(SpFrame *fr, SpArea *area)
+{
+    int32_t w = (area->colMax - area->colMin) * fr->step + fr->colW;
+
+    return SP_WINDOW_COST + 2 * w * (area->rowMax - area->rowMin + 1);
+}
+
+static void spFrameAddRows(SpFrame *fr, int16_t col, int16_t lvMin, int16_t lvMax)
+{
+    int16_t rowMin = fr->mirror ? lvMin : fr->height - 1 - lvMax;
+    int16_t rowMax = fr->mirror ? lvMax : fr->height - 1 - lvMin;
+
+    spAreaAdd(&fr->frame, col, rowMin, rowMax);
+    spAreaAdd(&fr->group[col / SP_GROUP_COLS], col, rowMin, rowMax);
+    fr->changed[col / 8] |= (uint8_t)(1 << (col % 8));
+}
+
+// Account changes of updated column: area to stream and column by column cost
+static void spFrameAddCol(SpFrame *fr, bool clear, int16_t col, int16_t oldPeak,
+                          SpectrumColumn spCol)
+{
+    const int16_t h = fr->height;
+
+    clampSpCol(&spCol, h, fr->peaks);
+
+    int16_t s = spCol.showW;
+    int16_t os = spCol.prevW;
+    int16_t p = spCol.peakW;
+    int16_t op = fr->peaks ? (oldPeak < h ? oldPeak : h - 1) : 0;
+
+    int16_t windows = (p > s);
+    int16_t pixels = (p > s);
 
     if (clear) {
-        memset(&spDrawData, 0, sizeof (SpDrawData));
-        memset(spData, 0, sizeof(spData));
+        windows += 2;
+        pixels += h;
+        spFrameAddRows(fr, col, 0, h - 1);
     } else {
-        if (chan == SP_CHAN_LEFT || chan == SP_CHAN_BOTH) {
-            spGetADC(SP_CHAN_LEFT, spData[SP_CHAN_LEFT].raw, SPECTRUM_SIZE, fftGet128);
+        windows += (s != os) + (p >= s);
+        pixels += (s > os ? s - os : os - s) + (p >= s);
+
+        if (s != os) {
+            spFrameAddRows(fr, col, s < os ? s : os, (s > os ? s : os) - 1);
+        }
+        if (op != p || (op > os) != (p > s)) {
+            if (op > os) {
+                spFrameAddRows(fr, col, op - 1, op - 1);
+            }
+            if (p > s) {
+                spFrameAddRows(fr, col, p - 1, p - 1);
+            }
+        }
+    }
+
+    if (fr->changed[col / 8] & (1 << (col % 8))) {
+        int32_t cost = windows * SP_WINDOW_COST + 2 * pixels * fr->colW;
+
+        fr->frame.colCost += cost;
+        fr->group[col / SP_GROUP_COLS].colCost += cost;
+    }
+}
+
+static color_t spFramePixel(SpFrame *fr, int16_t x, int16_t y)
+{
+    int16_t col = x / fr->step;
+
+    if (x - col * fr->step >= fr->colW) {
+        return canvas.pal->bg;
+    }
+
+    if (col != fr->loaded) {
+        loadSpCol(fr->chan, (uint8_t)col, &fr->spCol);
+        clampSpCol(&fr->spCol, fr->height, fr->peaks);
+        fr->loaded = col;
+    }
+
+    int16_t s = fr->spCol.showW;
+    int16_t p = fr->spCol.peakW;
+    int16_t level = fr->mirror ? y : fr->height - 1 - y;
+
+    if (level < s) {
+        return fr->grad[y];
+    }
+    if (p > s && level == p - 1) {
+        return canvas.pal->spPeak;
+    }
+
+    return canvas.pal->bg;
+}
+
+static void spFramePut(SpFrame *fr, color_t color)
+{
+    fr->buf[fr->len++] = color;
+
+    if (fr->len >= SP_LINE_SIZE) {
+        glcdStreamColors(fr->buf, fr->len);
+        fr->len = 0;
+    }
+}
+
+// Send changed area of columns as a single window
+static bool spFrameStream(SpFrame *fr, SpArea *area, int16_t x, int16_t y)
+{
+    int16_t x0 = area->colMin * fr->step;
+    int16_t x1 = area->colMax * fr->step + fr->colW - 1;
+    int16_t y0 = area->rowMin;
+    int16_t y1 = area->rowMax;
+
+    if (!glcdStreamBegin(x + x0, y + y0, x1 - x0 + 1, y1 - y0 + 1)) {
+        return false;
+    }
+
+    fr->loaded = -1;
+    fr->len = 0;
+
+    if (canvas.glcd->orientation & GLCD_PORTRATE) {
+        for (int16_t j = y0; j <= y1; j++) {
+            for (int16_t i = x1; i >= x0; i--) {
+                spFramePut(fr, spFramePixel(fr, i, j));
+            }
         }
-        if (chan == SP_CHAN_RIGHT || chan == SP_CHAN_BOTH) {
-            spGetADC(SP_CHAN_RIGHT, spData[SP_CHAN_RIGHT].raw, SPECTRUM_SIZE, fftGet128);
+    } else {
+        for (int16_t i = x0; i <= x1; i++) {
+            for (int16_t j = y0; j <= y1; j++) {
+                spFramePut(fr, spFramePixel(fr, i, j));
+            }
         }
     }
 
-    const int16_t step = (rect->w  + 1) / SPECTRUM_SIZE + 1;    // Step of columns
+    if (fr->len) {
+        glcdStreamColors(fr->buf, fr->len);
+    }
+    glcdStreamEnd();
+
+    return true;
+}
+
+static void drawSpectrum(bool clear, bool mirror, SpChan chan, GlcdRect *rect,
+                         SpData *spData)
+{
+    if (clear) {
+        memset(&spDrawData, 0, sizeof (SpDrawData));
+    }
+
+    const int16_t num = binMap.size;                            // Number of columns
+    const int16_t step = (rect->w + 1) / num;                   // Step of columns
     const int16_t colW = step - (step / 2);                     // Column width
-    const int16_t num = (rect->w + colW - 1) / step;            // Number of columns
 
     const int16_t width = (num - 1) * step + colW;              // Width of spectrum
     const int16_t height = rect->h;                             // Height of spectrum
@@ -457,19 +869,80 @@ static void drawSpectrum(bool clear, bool mirror, SpChan chan, GlcdRect *rect)
 
     Spectrum *sp = spGet();
 
-    color_t grad[512];
-    calcGradient(sp, height, mirror, grad);
+    color_t *grad = getGradient(sp, height, mirror);
+
+    SpFrame fr = {
+        .step = step,
+        .colW = colW,
+        .height = height,
+        .chan = chan,
+        .mirror = mirror,
+        .peaks = (sp->flags & SP_FLAG_PEAKS),
+        .grad = grad,
+    };
 
+    const SpArea empty = {num, -1, height, -1, 0};
+    fr.frame = empty;
+    for (int16_t i = 0; i < SPECTRUM_SIZE / SP_GROUP_COLS; i++) {
+        fr.group[i] = empty;
+    }
+
+    // Update all columns first to know what has changed
+    uint16_t oldPeak[SPECTRUM_SIZE];
     for (uint8_t col = 0; col < num; col++) {
-        int16_t x = oft + col * step;
+        oldPeak[col] = (chan == SP_CHAN_BOTH) ? spDrawData.both.peak[col] :
+                       spDrawData.chan.peak[chan][col];
+    }
+
+    calcSpFrame(chan, height, num, spData);
 
+    for (uint8_t col = 0; col < num; col++) {
         SpectrumColumn spCol;
-        calcSpCol(chan, height, col, &spCol, spData);
-        if (!(sp->flags & SP_FLAG_PEAKS)) {
-            spCol.peakW = 0;
+        loadSpCol(chan, col, &spCol);
+        spFrameAddCol(&fr, clear, col, (int16_t)oldPeak[col], spCol);
+    }
+
+    if (fr.frame.colMax < 0) {
+        return;
+    }
+
+    // Compare a single window for the frame with the best way for each group
+    int32_t groupCost = 0;
+    for (int16_t i = 0; i < SPECTRUM_SIZE / SP_GROUP_COLS; i++) {
+        SpArea *area = &fr.group[i];
+        if (area->colMax >= 0) {
+            int32_t streamCost = spAreaStreamCost(&fr, area);
+            groupCost += (streamCost < area->colCost ? streamCost : area->colCost);
+        }
+    }
+
+    if (spAreaStreamCost(&fr, &fr.frame) <= groupCost && spFrameStream(&fr, &fr.frame, oft, y)) {
+        return;
+    }
+
+    for (int16_t i = 0; i < SPECTRUM_SIZE / SP_GROUP_COLS; i++) {
+        SpArea *area = &fr.group[i];
+
+        if (area->colMax < 0) {
+            continue;
+        }
+        if (spAreaStreamCost(&fr, area) < area->colCost && spFrameStream(&fr, area, oft, y)) {
+            continue;
+        }
+
+        for (int16_t col = area->colMin; col <= area->colMax; col++) {
+            if (!(fr.changed[col / 8] & (1 << (col % 8)))) {
+                continue;
+            }
+
+            SpectrumColumn spCol;
+            loadSpCol(chan, (uint8_t)col, &spCol);
+            if (!(sp->flags & SP_FLAG_PEAKS)) {
+                spCol.peakW = 0;
+            }
+            GlcdRect rect = {oft + col * step, y, colW, height};
+            spectrumColumnDraw(clear, &spCol, &rect, mirror, grad);
         }
-        GlcdRect rect = {x, y, colW, height};
-        spectrumColumnDraw(clear, &spCol, &rect, mirror, grad);
     }
 }
 
@@ -842,6 +1315,17 @@ static void drawSpectrumMode(bool clear, GlcdRect rect)
 
     Spectrum *sp = spGet();
 
+    // Both channels are always taken from a single FFT
+    SpData spData[SP_CHAN_END];
+
+    checkBinMap((uint8_t)getSpectrumCols(rect.w));
+
+    if (clear) {
+        memset(spData, 0, sizeof(spData));
+    } else if (!spGetADC(SP_CHAN_BOTH, spData[SP_CHAN_LEFT].raw, SPECTRUM_SIZE, fftGetColumns)) {
+        return;
+    }
+
     switch (sp->mode) {
     case SP_MODE_STEREO:
     case SP_MODE_MIRROR:
@@ -849,13 +1333,13 @@ static void drawSpectrumMode(bool clear, GlcdRect rect)
     case SP_MODE_ANTIMIRROR:
         rect.h = rect.h / 2;
         drawSpectrum(clear, sp->mode == SP_MODE_ANTIMIRROR || sp->mode == SP_MODE_INVERTED,
-                     SP_CHAN_LEFT, &rect);
+                     SP_CHAN_LEFT, &rect, spData);
         rect.y += rect.h;
         drawSpectrum(clear, sp->mode == SP_MODE_MIRROR || sp->mode == SP_MODE_INVERTED,
-                     SP_CHAN_RIGHT, &rect);
+                     SP_CHAN_RIGHT, &rect, spData);
         break;
     default:
-        drawSpectrum(clear, false, SP_CHAN_BOTH, &rect);
+        drawSpectrum(clear, false, SP_CHAN_BOTH, &rect, spData);
         break;
     }
 }
@@ -1431,3 +1915,88 @@ void canvasDebugTimers()
         glcdWriteString(buf);
     }
 }
+
+void canvasDebugCache(void)
+{
+    return;
+
+    const Palette *pal = canvas.pal;
+    const Layout *lt = canvas.layout;
+    const tFont *font = lt->menu.menuFont;
+
+    const GlcdCacheStat *stat = glcdGetCacheStat();
+    uint32_t total = stat->hits + stat->misses;
+
+    glcdSetFont(font);
+    glcdSetFontColor(pal->active);
+    glcdSetFontAlign(GLCD_ALIGN_LEFT);
+
+    char buf[24];
+
+    glcdSetXY(0, canvas.glcd->rect.h - font->chars[0].image->height);
+    snprintf(buf, sizeof(buf), "%3d%% %5d/%2d",
+             total ? (int)(stat->hits * 100 / total) : 0, stat->used, stat->count);
+    glcdWriteString(buf);
+}
+
+void canvasDebugBus(void)
+{
+    return;
+
+    const Palette *pal = canvas.pal;
+    const Layout *lt = canvas.layout;
+    const tFont *font = lt->menu.menuFont;
+
+    // Bus traffic of the previous frame
+    static DispdrvStat prevStat;
+    const DispdrvStat *stat = dispdrvGetStat();
+
+    glcdSetFont(font);
+    glcdSetFontColor(pal->active);
+    glcdSetFontAlign(GLCD_ALIGN_LEFT);
+
+    char buf[32];
+
+    glcdSetXY(0, canvas.glcd->rect.h - 2 * font->chars[0].image->height);
+    snprintf(buf, sizeof(buf), "%4d %5d %4d %4d",
+             (int)(stat->windows - prevStat.windows), (int)(stat->cmds - prevStat.cmds),
+             (int)(stat->params - prevStat.params), (int)(stat->skipped - prevStat.skipped));
+    prevStat = *stat;
+    glcdWriteString(buf);
+}
+
+void canvasDebugEvents(void)
+{
+    return;
+
+    const Palette *pal = canvas.pal;
+    const Layout *lt = canvas.layout;
+    const tFont *font = lt->menu.menuFont;
+
+    // Worst latency of input events in us and share of wall time in sleep,
+    // averaged over a second as a frame may be shorter than the SysTick period
+    static EventStats prevStats;
+    static int sleepPct;
+    const EventStats *stats = eventGetStats();
+
+    uint32_t time = stats->time - prevStats.time;
+
+    if (time >= 1000) {
+        uint32_t busy = stats->busy - prevStats.busy;
+
+        sleepPct = busy < time * 1000 ? (int)(100 - busy / (time * 10)) : 0;
+        prevStats = *stats;
+    }
+
+    glcdSetFont(font);
+    glcdSetFontColor(pal->active);
+    glcdSetFontAlign(GLCD_ALIGN_LEFT);
+
+    char buf[32];
+
+    glcdSetXY(0, canvas.glcd->rect.h - 3 * font->chars[0].image->height);
+    snprintf(buf, sizeof(buf), "%5d %5d %5d %3d%%",
+             (int)stats->event[EVENT_TICK].max, (int)stats->event[EVENT_INPUT].max,
+             (int)stats->event[EVENT_RC].max, sleepPct);
+    glcdWriteString(buf);
+}
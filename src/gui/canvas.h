@@ -38,6 +38,9 @@ void canvasShowTimer(bool clear, int32_t value);
 
 void canvasDebugFPS(void);
 void canvasDebugTimers(void);
+void canvasDebugCache(void);
+void canvasDebugBus(void);
+void canvasDebugEvents(void);
 
 #ifdef __cplusplus
 }
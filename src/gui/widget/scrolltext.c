@@ -40,12 +40,15 @@ void scrollTextDraw(ScrollText *this, bool clear)
 {
     if (clear) {
         reset(this);
+        // Text may be rewritten in place, measure it again
+        glcdStrReset(&this->str);
     }
 
     const GlcdRect *rect = this->rect;
     const Palette *pal = paletteGet();
 
-    int16_t len = glcdCalcStringLen(this->text);
+    // Long text is measured once, not on every scroll step
+    int16_t len = glcdStrMeasure(&this->str, this->text);
     int16_t max_oft = len - rect->w;
 
     glcdSetRect(rect);
@@ -62,7 +65,7 @@ void scrollTextDraw(ScrollText *this, bool clear)
 
     if (clear) {
         glcdSetXY(this->oft, 0);
-        glcdWriteString(this->text);
+        glcdStrWrite(&this->str);
     }
 
     glcdResetRect();
@@ -21,6 +21,7 @@ enum {
 typedef struct {
     const GlcdRect *rect;
     const char *text;
+    GlcdStr str;
     int16_t oft;
     uint8_t pause;
     ScrollTextFlags flags;
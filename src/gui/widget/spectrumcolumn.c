@@ -1,9 +1,133 @@
 #include "spectrumcolumn.h"
 
 #include <stddef.h>
+#include <string.h>
 
 #include "gui/palette.h"
 
+#ifdef _SPCOL_SIMD
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include "cmsis_compiler.h"
+#elif !defined(_DSP_REF)
+#error "_SPCOL_SIMD needs DSP instructions (__ARM_FEATURE_DSP)"
+#endif
+
+// Lanes of x where a >= b, lanes of y otherwise
+__attribute__((always_inline))
+static inline uint32_t selGe(uint32_t a, uint32_t b, uint32_t x, uint32_t y, bool wide)
+{
+    if (wide) {
+        __USUB16(a, b);
+    } else {
+        __USUB8(a, b);
+    }
+    return __SEL(x, y);
+}
+
+__attribute__((always_inline))
+static inline uint32_t subSat(uint32_t a, uint32_t b, bool wide)
+{
+    return wide ? __UQSUB16(a, b) : __UQSUB8(a, b);
+}
+#else
+// Word at a time fallback: top bit of each lane is set aside, so borrows stay in lanes
+
+__attribute__((always_inline))
+static inline uint32_t maskGe(uint32_t a, uint32_t b, bool wide)
+{
+    uint32_t h = wide ? 0x80008000 : 0x80808080;
+    uint32_t low = ((a | h) - (b & ~h)) & h;
+    uint32_t ge = ((a & ~b) | (~(a ^ b) & low)) & h;
+
+    return ge | (ge - (ge >> (wide ? 15 : 7)));
+}
+
+__attribute__((always_inline))
+static inline uint32_t selGe(uint32_t a, uint32_t b, uint32_t x, uint32_t y, bool wide)
+{
+    uint32_t mask = maskGe(a, b, wide);
+
+    return (x & mask) | (y & ~mask);
+}
+
+__attribute__((always_inline))
+static inline uint32_t subSat(uint32_t a, uint32_t b, bool wide)
+{
+    uint32_t h = wide ? 0x80008000 : 0x80808080;
+    uint32_t diff = ((a | h) - (b & ~h)) ^ ((a ^ ~b) & h);
+
+    return diff & maskGe(a, b, wide);
+}
+#endif
+
+// Same steps as for a single column, done for all lanes of the word
+__attribute__((always_inline))
+static inline void calcWord(uint32_t r, uint32_t *show, uint32_t *prev, uint32_t *peak,
+                            uint32_t *fall, bool wide)
+{
+    const uint32_t one = wide ? 0x00010001 : 0x01010101;
+
+    uint32_t s = *show;
+    uint32_t p = *peak;
+    uint32_t f = *fall;
+
+    *prev = s;
+
+    // Below the value show falls with growing speed, but not under zero
+    uint32_t fs = subSat(s, f, wide);
+    f += selGe(r, s, 0, selGe(s, f, one, 0, wide), wide);
+    s = selGe(r, s, s, fs, wide);
+
+    // Above the value show jumps to it and speed restarts
+    f = selGe(s, r, f, one, wide);
+    s = selGe(r, s, r, s, wide);
+
+    // Peak is pushed up by the value, else it slowly falls to show
+    uint32_t pr = selGe(p, r + one, p, r + one, wide);
+    p = selGe(s + one, p, pr, subSat(p, one, wide), wide);
+
+    *show = s;
+    *peak = p;
+    *fall = f;
+}
+
+__attribute__((always_inline))
+static inline void calcFrame(void *show, void *prev, void *peak, void *fall, const void *raw,
+                             size_t size, bool wide)
+{
+    for (size_t i = 0; i < size; i += sizeof (uint32_t)) {
+        uint32_t r, s, o, p, f;
+
+        memcpy(&r, (const uint8_t *)raw + i, sizeof (r));
+        memcpy(&s, (uint8_t *)show + i, sizeof (s));
+        memcpy(&p, (uint8_t *)peak + i, sizeof (p));
+        memcpy(&f, (uint8_t *)fall + i, sizeof (f));
+
+        calcWord(r, &s, &o, &p, &f, wide);
+
+        memcpy((uint8_t *)show + i, &s, sizeof (s));
+        memcpy((uint8_t *)prev + i, &o, sizeof (o));
+        memcpy((uint8_t *)peak + i, &p, sizeof (p));
+        memcpy((uint8_t *)fall + i, &f, sizeof (f));
+    }
+}
+
+void spectrumColumnCalc8(uint8_t *show, uint8_t *prev, uint8_t *peak, uint8_t *fall,
+                         const uint8_t *raw, int16_t count)
+{
+    size_t size = ((size_t)count + 3) & ~(size_t)3;
+
+    calcFrame(show, prev, peak, fall, raw, size, false);
+}
+
+void spectrumColumnCalc16(uint16_t *show, uint16_t *prev, uint16_t *peak, uint16_t *fall,
+                          const uint16_t *raw, int16_t count)
+{
+    size_t size = (((size_t)count + 1) & ~(size_t)1) * sizeof (uint16_t);
+
+    calcFrame(show, prev, peak, fall, raw, size, true);
+}
+
 void spectrumColumnDraw(bool clear, SpectrumColumn *col, GlcdRect *rect, bool mirror, color_t *grad)
 {
     int16_t x = rect->x;
@@ -19,6 +19,13 @@ typedef struct {
 
 void spectrumColumnDraw(bool clear, SpectrumColumn *col, GlcdRect *rect, bool mirror, color_t *grad);
 
+// Update all columns of a frame, kept as arrays of 8-bit or 16-bit values.
+// Arrays are processed by words, so they must have room up to the word boundary.
+void spectrumColumnCalc8(uint8_t *show, uint8_t *prev, uint8_t *peak, uint8_t *fall,
+                         const uint8_t *raw, int16_t count);
+void spectrumColumnCalc16(uint16_t *show, uint16_t *prev, uint16_t *peak, uint16_t *fall,
+                          const uint16_t *raw, int16_t count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,88 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fft.h"
+#include "fftref.h"
+
+// Accuracy of the fixed point FFT against DFT in double of the same
+// windowed 12-bit input: SNR over bins 1..N/2-1 for each input level.
+// "old" is the former pipeline (input >> 2, fixed scaling in every stage),
+// "bfp" is fft_prepare() with full ADC resolution and fft_radix4_bfp().
+// Fails if bfp loses to old at any level or is below SNR_MIN down to LEVEL_MIN.
+
+#define BLOCKS          50
+#define FULL_SCALE      2047
+
+#define SNR_MIN         40.0
+#define LEVEL_MIN       -20
+
+static double window[FFT_SIZE];
+
+int main(void)
+{
+    // Same Hamming coefficients as the window table, scaled by 2^16
+    for (int i = 0; i < FFT_SIZE / 2; i++) {
+        uint16_t ht = (uint16_t)(35281 - ((30253 * fft_cos((int16_t)i)) >> 15));
+        window[i] = window[FFT_SIZE - 1 - i] = ht / 65536.0;
+    }
+
+    bool ok = true;
+
+    srand(1);
+
+    printf("level, dBFS   old SNR, dB   bfp SNR, dB\n");
+
+    for (int level = 0; level >= -60; level -= 10) {
+        double sig = 0;
+        double errOld = 0;
+        double errBfp = 0;
+
+        for (int b = 0; b < BLOCKS; b++) {
+            double amp = FULL_SCALE * pow(10, level / 20.0);
+            double freq = 37.3 + b * 3.1;
+            int16_t x[FFT_SIZE];
+            int16_t xOld[FFT_SIZE];
+            int32_t dc = 0;
+
+            for (int i = 0; i < FFT_SIZE; i++) {
+                x[i] = (int16_t)lrint(2048 + amp * sin(2 * M_PI * freq * i / FFT_SIZE) + rand() % 3 - 1);
+                dc += x[i];
+            }
+            dc /= FFT_SIZE;
+
+            double v[FFT_SIZE];
+            double re[FFT_SIZE / 2];
+            double im[FFT_SIZE / 2];
+
+            for (int i = 0; i < FFT_SIZE; i++) {
+                v[i] = (x[i] - dc) * window[i];
+            }
+            ref_dft(v, re, im);
+            sig += ref_dft_power(re, im);
+
+            FftSample old[FFT_SIZE];
+            FftSample bfp[FFT_SIZE];
+
+            for (int i = 0; i < FFT_SIZE; i++) {
+                xOld[i] = (int16_t)(x[i] - dc) >> 2;
+            }
+            ref_fft_prepare(old, xOld, NULL, 1, 0, 0);
+            ref_fft_radix4(old, false);
+            errOld += ref_dft_error(old, 2, re, im);
+
+            fft_prepare(bfp, x, NULL, 1, (int16_t)dc, 0);
+            int8_t exp = fft_radix4_bfp(bfp);
+            errBfp += ref_dft_error(bfp, exp, re, im);
+        }
+
+        double snrOld = 10 * log10(sig / errOld);
+        double snrBfp = 10 * log10(sig / errBfp);
+
+        printf("%11d   %11.1f   %11.1f\n", level, snrOld, snrBfp);
+        ok &= snrBfp > snrOld && (level < LEVEL_MIN || snrBfp >= SNR_MIN);
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+#include "host.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "amp.h"
+#include "display/dispdrv.h"
+#include "display/dispdrv/virtual.h"
+#include "gui/canvas.h"
+#include "mpc.h"
+#include "spectrum.h"
+#include "swtimers.h"
+#include "tr/labels.h"
+#include "tuner/tuner.h"
+
+// Draws every screen on the virtual panel and prints display bus traffic:
+// first frame after clear and the mean of the next update frames
+
+#define FRAMES          50
+#define FRAME_MS        20
+
+typedef struct {
+    const char *name;
+    void (*show)(bool clear);
+} Screen;
+
+static void setSpMode(SpMode mode, bool clear)
+{
+    if (clear) {
+        spGet()->mode = mode;
+    }
+    canvasShowSpectrum(clear);
+}
+
+static void showTime(bool clear)
+{
+    canvasShowTime(clear);
+}
+
+static void showStereo(bool clear)
+{
+    setSpMode(SP_MODE_STEREO, clear);
+}
+
+static void showMirror(bool clear)
+{
+    setSpMode(SP_MODE_MIRROR, clear);
+}
+
+static void showMixed(bool clear)
+{
+    setSpMode(SP_MODE_MIXED, clear);
+}
+
+static void showWaterfall(bool clear)
+{
+    setSpMode(SP_MODE_WATERFALL, clear);
+}
+
+static void showVolume(bool clear)
+{
+    canvasShowTune(clear, AUDIO_TUNE_VOLUME);
+}
+
+static void showMenu(bool clear)
+{
+    canvasShowMenu(clear);
+}
+
+static void showTuner(bool clear)
+{
+    Tuner *tuner = tunerGet();
+
+    tuner->par.fMin = 8750;
+    tuner->par.fMax = 10800;
+    tuner->status.freq = 10170;
+    tuner->status.rssi = 40;
+
+    canvasShowTuner(clear);
+}
+
+static void showMpd(bool clear)
+{
+    Mpc *mpc = mpcGet();
+
+    if (clear) {
+        mpc->status = MPC_PLAYING;
+        strcpy(mpc->meta, "Some Artist - A song title long enough to be scrolled");
+        mpc->flags |= MPC_FLAG_UPDATE_META;
+    }
+    mpc->elapsed++;
+
+    canvasShowMpd(clear, ICON_EMPTY);
+}
+
+static void showTimer(bool clear)
+{
+    canvasShowTimer(clear, 3600000 - (int32_t)swTimGet(SW_TIM_SYSTEM));
+}
+
+static void showStars(bool clear)
+{
+    canvasShowStars(clear, 0);
+}
+
+static const Screen screens[] = {
+    {"time",        showTime},
+    {"stereo",      showStereo},
+    {"mirror",      showMirror},
+    {"mixed",       showMixed},
+    {"waterfall",   showWaterfall},
+    {"volume",      showVolume},
+    {"menu",        showMenu},
+    {"tuner",       showTuner},
+    {"mpd",         showMpd},
+    {"timer",       showTimer},
+    {"stars",       showStars},
+};
+
+typedef struct {
+    DispdrvStat drv;
+    VirtualStat bus;
+} Stat;
+
+static void getStat(Stat *stat)
+{
+    stat->drv = *dispdrvGetStat();
+    stat->bus = *virtualGetStat();
+}
+
+static void printStat(const char *name, const char *frame, const Stat *from, const Stat *to,
+                      uint32_t div)
+{
+    printf("%-10s %-7s %8u %8u %7u %7u %7u %9u %8u\n", name, frame,
+           (to->drv.cmds - from->drv.cmds) / div,
+           (to->drv.params - from->drv.params) / div,
+           (to->drv.windows - from->drv.windows) / div,
+           (to->drv.skipped - from->drv.skipped) / div,
+           (to->bus.selects - from->bus.selects) / div,
+           (to->bus.cycles - from->bus.cycles) / div,
+           (to->bus.pixels - from->bus.pixels) / div);
+}
+
+int main(int argc, char *argv[])
+{
+    // Optional directory to dump the last frame of each screen
+    const char *dir = argc > 1 ? argv[1] : NULL;
+
+    labelsInit();
+    canvasInit();
+
+    printf("%-10s %-7s %8s %8s %7s %7s %7s %9s %8s\n", "screen", "frame",
+           "cmds", "params", "windows", "skipped", "selects", "cycles", "pixels");
+
+    for (size_t i = 0; i < sizeof(screens) / sizeof(screens[0]); i++) {
+        const Screen *scr = &screens[i];
+        Stat s0, s1, s2;
+
+        canvasClear();
+
+        getStat(&s0);
+        scr->show(true);
+        getStat(&s1);
+
+        for (int f = 0; f < FRAMES; f++) {
+            hostTick(FRAME_MS);
+            scr->show(false);
+        }
+        getStat(&s2);
+
+        printStat(scr->name, "clear", &s0, &s1, 1);
+        printStat(scr->name, "update", &s1, &s2, FRAMES);
+
+        if (dir) {
+            char name[256];
+            snprintf(name, sizeof(name), "%s/%s.ppm", dir, scr->name);
+            virtualDumpPpm(name);
+        }
+    }
+
+    return 0;
+}
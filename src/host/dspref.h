@@ -0,0 +1,130 @@
+#ifndef DSPREF_H
+#define DSPREF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Portable versions of ARMv7E-M DSP instructions under their CMSIS names,
+// so packed (_FFT_SIMD, _SPCOL_SIMD) code runs on the host.
+// Include it before the production source file, only in host builds.
+
+#define _DSP_REF
+
+#define LO16(x)     ((int16_t)((x) & 0xFFFF))
+#define HI16(x)     ((int16_t)((x) >> 16))
+
+// GE flags set by USUB8/USUB16 and read by SEL
+static uint32_t ref_ge;
+
+static inline int32_t ref_ssat16(int32_t x)
+{
+    return x > INT16_MAX ? INT16_MAX : (x < INT16_MIN ? INT16_MIN : x);
+}
+
+static inline uint32_t ref_pack16(int32_t lo, int32_t hi)
+{
+    return ((uint32_t)lo & 0xFFFF) | ((uint32_t)hi << 16);
+}
+
+static inline uint32_t ref_usub(uint32_t op1, uint32_t op2, uint8_t bits, bool sat)
+{
+    uint32_t mask = (1U << bits) - 1;
+    uint32_t geMask = (1U << (bits / 8)) - 1;
+    uint32_t ret = 0;
+
+    ref_ge = 0;
+    for (uint8_t i = 0; i < 32; i += bits) {
+        uint32_t a = (op1 >> i) & mask;
+        uint32_t b = (op2 >> i) & mask;
+
+        if (a >= b) {
+            ref_ge |= geMask << (i / 8);
+        }
+        ret |= ((sat && a < b) ? 0 : ((a - b) & mask)) << i;
+    }
+
+    return ret;
+}
+
+static inline uint32_t __QADD16(uint32_t op1, uint32_t op2)
+{
+    return ref_pack16(ref_ssat16(LO16(op1) + LO16(op2)), ref_ssat16(HI16(op1) + HI16(op2)));
+}
+
+static inline uint32_t __QSUB16(uint32_t op1, uint32_t op2)
+{
+    return ref_pack16(ref_ssat16(LO16(op1) - LO16(op2)), ref_ssat16(HI16(op1) - HI16(op2)));
+}
+
+static inline uint32_t __QASX(uint32_t op1, uint32_t op2)
+{
+    return ref_pack16(ref_ssat16(LO16(op1) - HI16(op2)), ref_ssat16(HI16(op1) + LO16(op2)));
+}
+
+static inline uint32_t __QSAX(uint32_t op1, uint32_t op2)
+{
+    return ref_pack16(ref_ssat16(LO16(op1) + HI16(op2)), ref_ssat16(HI16(op1) - LO16(op2)));
+}
+
+static inline uint32_t __SMUSD(uint32_t op1, uint32_t op2)
+{
+    return (uint32_t)(LO16(op1) * LO16(op2)) - (uint32_t)(HI16(op1) * HI16(op2));
+}
+
+static inline uint32_t __SMUADX(uint32_t op1, uint32_t op2)
+{
+    return (uint32_t)(LO16(op1) * HI16(op2)) + (uint32_t)(HI16(op1) * LO16(op2));
+}
+
+#define __PKHBT(ARG1, ARG2, ARG3) \
+    ((((uint32_t)(ARG1)) & 0x0000FFFFUL) | ((((uint32_t)(ARG2)) << (ARG3)) & 0xFFFF0000UL))
+
+static inline uint32_t __USUB8(uint32_t op1, uint32_t op2)
+{
+    return ref_usub(op1, op2, 8, false);
+}
+
+static inline uint32_t __USUB16(uint32_t op1, uint32_t op2)
+{
+    return ref_usub(op1, op2, 16, false);
+}
+
+// Saturating subtraction doesn't change GE flags
+static inline uint32_t __UQSUB8(uint32_t op1, uint32_t op2)
+{
+    uint32_t ge = ref_ge;
+    uint32_t ret = ref_usub(op1, op2, 8, true);
+
+    ref_ge = ge;
+    return ret;
+}
+
+static inline uint32_t __UQSUB16(uint32_t op1, uint32_t op2)
+{
+    uint32_t ge = ref_ge;
+    uint32_t ret = ref_usub(op1, op2, 16, true);
+
+    ref_ge = ge;
+    return ret;
+}
+
+static inline uint32_t __SEL(uint32_t op1, uint32_t op2)
+{
+    uint32_t ret = 0;
+
+    for (uint8_t i = 0; i < 4; i++) {
+        ret |= (((ref_ge >> i) & 1) ? op1 : op2) & (0xFFU << (8 * i));
+    }
+
+    return ret;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DSPREF_H
@@ -0,0 +1,236 @@
+#include "fftref.h"
+
+#include <math.h>
+
+#define N_HANN          1024
+#define FFT_BFP_LIMIT   4096
+
+static inline void sum_dif(int16_t a, int16_t b,
+                           int16_t *s, int16_t *d)
+{
+    *s = a + b;
+    *d = a - b;
+}
+
+static inline void mult_shf(int16_t cos, int16_t sin, int16_t x, int16_t y,
+                            int16_t *u, int16_t *v)
+{
+    *u = (x * cos - y * sin) >> 15;
+    *v = (y * cos + x * sin) >> 15;
+}
+
+static void rev_bin(FftSample *sp)
+{
+    int16_t m, mr = 0;
+    int16_t l;
+    FftSample t;
+
+    for (m = 1; m < FFT_SIZE; m++) {
+        l = FFT_SIZE;
+        do {
+            l >>= 1;
+        } while (mr + l >= FFT_SIZE);
+
+        mr = (mr & (l - 1)) + l;
+
+        if (mr <= m) {
+            continue;
+        }
+        t = sp[m];
+        sp[m] = sp[mr];
+        sp[mr] = t;
+    }
+}
+
+static void hamm_window(FftSample *sp)
+{
+    for (int16_t i = 0; i < FFT_SIZE / 2; i++) {
+        // Use Hamm coefficients 0.53836 and 0.46164 scaled by SIN_SCALE = 2^15
+        uint16_t ht = (uint16_t)(35281 - ((30253 * fft_cos(i * (N_HANN / FFT_SIZE))) >> 15));
+
+        sp[i].fr = (ht * sp[i].fr) >> 16;
+        sp[i].fi = (ht * sp[i].fi) >> 16;
+        sp[FFT_SIZE - 1 - i].fr = (ht * sp[FFT_SIZE - 1 - i].fr) >> 16;
+        sp[FFT_SIZE - 1 - i].fi = (ht * sp[FFT_SIZE - 1 - i].fi) >> 16;
+    }
+}
+
+static int8_t bfp_scale(FftSample *sp)
+{
+    int16_t max = 0;
+    int8_t shift = 0;
+
+    for (int16_t i = 0; i < FFT_SIZE; i++) {
+        int16_t r = sp[i].fr < 0 ? ~sp[i].fr : sp[i].fr;
+        int16_t m = sp[i].fi < 0 ? ~sp[i].fi : sp[i].fi;
+
+        if (r > max) {
+            max = r;
+        }
+        if (m > max) {
+            max = m;
+        }
+    }
+
+    while ((max >> shift) >= FFT_BFP_LIMIT) {
+        shift++;
+    }
+
+    for (int16_t i = 0; i < FFT_SIZE && shift; i++) {
+        sp[i].fr >>= shift;
+        sp[i].fi >>= shift;
+    }
+
+    return shift;
+}
+
+void ref_fft_prepare(FftSample *sp, const int16_t *re, const int16_t *im, int16_t stride,
+                     int16_t dcRe, int16_t dcIm)
+{
+    for (int16_t i = 0; i < FFT_SIZE; i++) {
+        sp[i].fr = re[i * stride] - dcRe;
+        sp[i].fi = im ? im[i * stride] - dcIm : 0;
+    }
+
+    hamm_window(sp);
+    rev_bin(sp);
+}
+
+int8_t ref_fft_radix4(FftSample *sp, bool bfp)
+{
+    int16_t ldm = 0, rdx = 2;
+    int8_t exp = 0;
+
+    if (bfp) {
+        exp += bfp_scale(sp);
+    }
+
+    for (int16_t i0 = 0; i0 < FFT_SIZE; i0 += 4) {
+        int16_t i1 = i0 + 1;
+        int16_t i2 = i1 + 1;
+        int16_t i3 = i2 + 1;
+
+        int16_t xr, yr, ur, vr, xi, yi, ui, vi;
+
+        sum_dif(sp[i0].fr, sp[i1].fr, &xr, &ur);
+        sum_dif(sp[i2].fr, sp[i3].fr, &yr, &vi);
+        sum_dif(sp[i0].fi, sp[i1].fi, &xi, &ui);
+        sum_dif(sp[i3].fi, sp[i2].fi, &yi, &vr);
+
+        sum_dif(ui, vi, &sp[i1].fi, &sp[i3].fi);
+        sum_dif(xi, yi, &sp[i0].fi, &sp[i2].fi);
+        sum_dif(ur, vr, &sp[i1].fr, &sp[i3].fr);
+        sum_dif(xr, yr, &sp[i0].fr, &sp[i2].fr);
+    }
+
+    for (ldm = 2 * rdx; ldm <= FFT_LOG2; ldm += rdx) {
+        int16_t m = (1 << ldm);
+        int16_t m4 = (m >> rdx);
+
+        int16_t phi0 =  N_WAVE / m;
+        int16_t phi  = 0;
+
+        if (bfp) {
+            exp += bfp_scale(sp);
+        }
+
+        for (int16_t i = 0; i < m4; i++) {
+            int16_t sin1, sin2, sin3;
+            int16_t cos1, cos2, cos3;
+
+            sin1 = fft_sin(1 * phi);
+            sin2 = fft_sin(2 * phi);
+            sin3 = fft_sin(3 * phi);
+
+            cos1 = fft_cos(1 * phi);
+            cos2 = fft_cos(2 * phi);
+            cos3 = fft_cos(3 * phi);
+
+            for (int16_t r = 0; r < FFT_SIZE; r += m) {
+                int16_t i0 = i + r;
+                int16_t i1 = i0 + m4;
+                int16_t i2 = i1 + m4;
+                int16_t i3 = i2 + m4;
+
+                int16_t xr, yr, ur, vr, xi, yi, ui, vi;
+                int16_t t;
+
+                mult_shf(cos2, sin2, sp[i1].fr, sp[i1].fi, &xr, &xi);
+                mult_shf(cos1, sin1, sp[i2].fr, sp[i2].fi, &yr, &vr);
+                mult_shf(cos3, sin3, sp[i3].fr, sp[i3].fi, &vi, &yi);
+
+                t = yi - vr;
+                yi += vr;
+                vr = t;
+
+                ur = sp[i0].fr - xr;
+                xr += sp[i0].fr;
+
+                sum_dif(ur, vr, &sp[i1].fr, &sp[i3].fr);
+
+                t = yr - vi;
+                yr += vi;
+                vi = t;
+
+                ui = sp[i0].fi - xi;
+                xi += sp[i0].fi;
+
+                sum_dif(ui, vi, &sp[i1].fi, &sp[i3].fi);
+                sum_dif(xr, yr, &sp[i0].fr, &sp[i2].fr);
+                sum_dif(xi, yi, &sp[i0].fi, &sp[i2].fi);
+            }
+            phi += phi0;
+        }
+    }
+
+    return exp;
+}
+
+void ref_dft(const double *x, double *re, double *im)
+{
+    static double cosTable[FFT_SIZE];
+    static double sinTable[FFT_SIZE];
+
+    if (sinTable[1] == 0) {
+        for (int i = 0; i < FFT_SIZE; i++) {
+            cosTable[i] = cos(2 * M_PI * i / FFT_SIZE);
+            sinTable[i] = sin(2 * M_PI * i / FFT_SIZE);
+        }
+    }
+
+    for (int k = 1; k < FFT_SIZE / 2; k++) {
+        re[k] = 0;
+        im[k] = 0;
+        for (int n = 0; n < FFT_SIZE; n++) {
+            int ph = (k * n) % FFT_SIZE;
+
+            re[k] += x[n] * cosTable[ph];
+            im[k] += x[n] * sinTable[ph];
+        }
+    }
+}
+
+double ref_dft_power(const double *re, const double *im)
+{
+    double pwr = 0;
+
+    for (int k = 1; k < FFT_SIZE / 2; k++) {
+        pwr += re[k] * re[k] + im[k] * im[k];
+    }
+
+    return pwr;
+}
+
+double ref_dft_error(const FftSample *sp, int8_t exp, const double *re, const double *im)
+{
+    double err = 0;
+
+    for (int k = 1; k < FFT_SIZE / 2; k++) {
+        double dre = ldexp(sp[k].fr, exp) - re[k];
+        double dim = ldexp(sp[k].fi, exp) - im[k];
+
+        err += dre * dre + dim * dim;
+    }
+
+    return err;
+}
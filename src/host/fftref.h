@@ -0,0 +1,36 @@
+#ifndef FFTREF_H
+#define FFTREF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+#include "fft.h"
+
+// FFT steps as they were before the table driven kernel: window computed
+// by fft_cos(), loop based bit reversal and twiddles by fft_sin()/fft_cos()
+
+void ref_fft_prepare(FftSample *sp, const int16_t *re, const int16_t *im, int16_t stride,
+                     int16_t dcRe, int16_t dcIm);
+
+// With bfp the block is scaled before each stage by the same rule as
+// fft_radix4_bfp(), returns exponent
+int8_t ref_fft_radix4(FftSample *sp, bool bfp);
+
+// DFT in double of real input x, bins 1..FFT_SIZE/2-1. The sign follows
+// the kernel, which is conjugated against the usual DFT
+void ref_dft(const double *x, double *re, double *im);
+
+// Power of ref_dft() result
+double ref_dft_power(const double *re, const double *im);
+
+// Squared error of kernel output scaled by 2^exp against ref_dft() result
+double ref_dft_error(const FftSample *sp, int8_t exp, const double *re, const double *im);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FFTREF_H
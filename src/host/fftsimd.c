@@ -0,0 +1,14 @@
+#include "fftsimd.h"
+
+#include "dspref.h"
+
+// Public names get simd_ prefix to link together with the scalar fft.c
+
+#define fft_sin             simd_fft_sin
+#define fft_cos             simd_fft_cos
+#define fft_prepare         simd_fft_prepare
+#define fft_radix4_bfp      simd_fft_radix4_bfp
+#define fft_split           simd_fft_split
+
+#define _FFT_SIMD
+#include "fft.c"
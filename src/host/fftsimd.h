@@ -0,0 +1,22 @@
+#ifndef FFTSIMD_H
+#define FFTSIMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "fft.h"
+
+// fft.c built with _FFT_SIMD, on the host it runs the packed kernel
+// with portable versions of the DSP intrinsics
+
+void simd_fft_prepare(FftSample *sp, const int16_t *re, const int16_t *im, int16_t stride,
+                      int16_t dcRe, int16_t dcIm);
+int8_t simd_fft_radix4_bfp(FftSample *sp);
+void simd_fft_split(FftSample *sp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FFTSIMD_H
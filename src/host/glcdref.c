@@ -0,0 +1,272 @@
+#include "glcdref.h"
+
+#include <string.h>
+
+// Uncompress image to storage
+static void ref_unRleImg(const tImage *img, uint8_t *data)
+{
+    if (!img->rle) {
+        memcpy(data, img->data, img->size);
+        return;
+    }
+
+    const uint8_t *inPtr = img->data;
+    uint8_t *outPtr = data;
+
+    while (inPtr < img->data + img->size) {
+        int8_t size = (int8_t)(*inPtr);
+        inPtr++;
+        if (size < 0) {
+            for (uint8_t i = 0; i < -size; i++) {
+                *outPtr++ = *inPtr++;
+            }
+        } else if (size > 0) {
+            uint8_t data = *inPtr;
+            for (uint8_t i = 0; i < size; i++) {
+                *outPtr++ = data;
+            }
+            inPtr++;
+        } else {
+            return;
+        }
+    }
+}
+
+int16_t ref_glcdDrawImage(const tImage *img, int16_t x, int16_t y,
+                          color_t color, color_t bgColor)
+{
+    if (img == NULL) {
+        return 0;
+    }
+
+    uint8_t data[(size_t)(img->width * ((img->height + 7) / 8))];
+    ref_unRleImg(img, data);
+
+    for (int16_t i = 0; i < img->width; i++) {
+        for (int16_t j = 0; j < img->height; j++) {
+            bool set = data[img->width * (j >> 3) + i] & (1 << (j & 0x7));
+            glcdDrawPixel(x + i, y + j, set ? color : bgColor);
+        }
+    }
+
+    return img->width;
+}
+
+static int16_t ref_charWidth(UChar code)
+{
+    int16_t pos = glcdFontSymbolPos(code);
+
+    if (pos < 0) {
+        return 0;
+    }
+
+    return glcdGet()->font->chars[pos].image->width;
+}
+
+int16_t ref_glcdWriteString(const char *string, int16_t x, int16_t y)
+{
+    Glcd *glcd = glcdGet();
+
+    if (string == NULL || glcd->font == NULL) {
+        return 0;
+    }
+
+    UChar ustr[strlen(string) + 1];
+    uint16_t len = glcdStrToUStr(string, ustr);
+
+    int16_t lsp = ref_charWidth(LETTER_SPACE_CHAR);
+    int16_t h = glcd->font->chars[0].image->height;
+
+    int16_t sLen = glcd->strFramed ? 2 * lsp : 0;
+    for (uint16_t i = 0; i < len; i++) {
+        sLen += ref_charWidth(ustr[i]);
+        if (i + 1 < len) {
+            sLen += lsp;
+        }
+    }
+
+    if (glcd->fontAlign == GLCD_ALIGN_CENTER) {
+        x -= sLen / 2;
+    } else if (glcd->fontAlign == GLCD_ALIGN_RIGHT) {
+        x -= sLen;
+    }
+
+    if (glcd->strFramed) {
+        glcdDrawRect(x, y, lsp, h, glcd->fontBg);
+        x += lsp;
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        int16_t pos = glcdFontSymbolPos(ustr[i]);
+        if (pos >= 0) {
+            x += ref_glcdDrawImage(glcd->font->chars[pos].image, x, y, glcd->fontFg, glcd->fontBg);
+        }
+        if (i + 1 < len) {
+            glcdDrawRect(x, y, lsp, h, glcd->fontBg);
+            x += lsp;
+        }
+    }
+    if (glcd->strFramed) {
+        glcdDrawRect(x, y, lsp, h, glcd->fontBg);
+    }
+
+    return sLen;
+}
+
+void ref_glcdDrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, color_t color)
+{
+    if (x0 == x1) {                 // Vertical
+        if (y0 > y1) {              // Swap
+            y0 = y0 + y1;
+            y1 = y0 - y1;
+            y0 = y0 - y1;
+        }
+        glcdDrawRect(x0, y0, 1, y1 - y0 + 1, color);
+    } else if (y0 == y1) {          // Horisontal
+        if (x0 > x1) {              // Swap
+            x0 = x0 + x1;
+            x1 = x0 - x1;
+            x0 = x0 - x1;
+        }
+        glcdDrawRect(x0, y0, x1 - x0 + 1, 1, color);
+    } else {
+        int16_t sX, sY, dX, dY, err;
+
+        sX = x0 < x1 ? 1 : -1;
+        sY = y0 < y1 ? 1 : -1;
+        dX = sX > 0 ? x1 - x0 : x0 - x1;
+        dY = sY > 0 ? y1 - y0 : y0 - y1;
+        err = dX - dY;
+
+        while (x0 != x1 || y0 != y1) {
+            glcdDrawPixel(x0, y0, color);
+            int16_t err2 = err * 2;
+            if (err2 > -dY / 2) {
+                err -= dY;
+                x0 += sX;
+            }
+            if (err2 < dX) {
+                err += dX;
+                y0 += sY;
+            }
+        }
+        glcdDrawPixel(x1, y1, color);
+    }
+}
+
+void ref_glcdDrawRFrame(int16_t x, int16_t y, int16_t w, int16_t h, int16_t t, int16_t r,
+                        color_t color)
+{
+    int16_t xc = x + r;
+    int16_t yc = y + r;
+
+    int16_t xo = r;
+    int16_t xi = xo - t + 1;
+    int16_t yo = 0;
+    int16_t erro = 1 - xo;
+    int16_t erri = 1 - xi;
+
+    while (xo >= yo) {
+        ref_glcdDrawLine(xc + xi + w - 2 * r - 1, yc + yo + h - 2 * r - 1, xc + xo + w - 2 * r - 1,
+                         yc + yo + h - 2 * r - 1, color);
+        ref_glcdDrawLine(xc + yo + w - 2 * r - 1, yc + xi + h - 2 * r - 1, xc + yo + w - 2 * r - 1,
+                         yc + xo + h - 2 * r - 1, color);
+        ref_glcdDrawLine(xc - xo, yc + yo + h - 2 * r - 1, xc - xi, yc + yo + h - 2 * r - 1, color);
+        ref_glcdDrawLine(xc - yo, yc + xi + h - 2 * r - 1, xc - yo, yc + xo + h - 2 * r - 1, color);
+        ref_glcdDrawLine(xc - xo, yc - yo, xc - xi, yc - yo, color);
+        ref_glcdDrawLine(xc - yo, yc - xo, xc - yo, yc - xi, color);
+        ref_glcdDrawLine(xc + xi + w - 2 * r - 1, yc - yo, xc + xo + w - 2 * r - 1, yc - yo, color);
+        ref_glcdDrawLine(xc + yo + w - 2 * r - 1, yc - xo, xc + yo + w - 2 * r - 1, yc - xi, color);
+
+        yo++;
+
+        if (erro < 0) {
+            erro += 2 * yo + 1;
+        } else {
+            xo--;
+            erro += 2 * (yo - xo + 1);
+        }
+
+        if (yo > xo - t + 1) {
+            xi = yo;
+        } else {
+            if (erri < 0) {
+                erri += 2 * yo + 1;
+            } else {
+                xi--;
+                erri += 2 * (yo - xi + 1);
+            }
+        }
+    }
+
+    glcdDrawRect(x + r + 1, y, w - 2 * r - 2, t,  color);
+    glcdDrawRect(x, y + r + 1, t, h - 2 * r - 2, color);
+    glcdDrawRect(x + r + 1, y + h - t, w - 2 * r - 2, t, color);
+    glcdDrawRect(x + w - t, y + r + 1, t, h - 2 * r - 2, color);
+}
+
+void ref_glcdDrawCircle(int16_t xc, int16_t yc, int16_t r, color_t color)
+{
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        ref_glcdDrawLine(xc - x, yc + y, xc + x, yc + y, color);
+        ref_glcdDrawLine(xc - x, yc - y, xc + x, yc - y, color);
+        ref_glcdDrawLine(xc - y, yc - x, xc - y, yc + x, color);
+        ref_glcdDrawLine(xc + y, yc - x, xc + y, yc + x, color);
+    }
+
+    glcdDrawRect(xc - x, yc - y, 2 * x, 2 * y, color);
+}
+
+void ref_glcdDrawRing(int16_t xc, int16_t yc, int16_t r, int16_t t, color_t color)
+{
+    int16_t xo = r;
+    int16_t xi = xo - t + 1;
+    int16_t y = 0;
+    int16_t erro = 1 - xo;
+    int16_t erri = 1 - xi;
+
+    while (xo >= y) {
+        ref_glcdDrawLine(xc + xi, yc + y, xc + xo, yc + y, color);
+        ref_glcdDrawLine(xc + y, yc + xi, xc + y, yc + xo, color);
+        ref_glcdDrawLine(xc - xo, yc + y, xc - xi, yc + y, color);
+        ref_glcdDrawLine(xc - y, yc + xi, xc - y, yc + xo, color);
+        ref_glcdDrawLine(xc - xo, yc - y, xc - xi, yc - y, color);
+        ref_glcdDrawLine(xc - y, yc - xo, xc - y, yc - xi, color);
+        ref_glcdDrawLine(xc + xi, yc - y, xc + xo, yc - y, color);
+        ref_glcdDrawLine(xc + y, yc - xo, xc + y, yc - xi, color);
+
+        y++;
+
+        if (erro < 0) {
+            erro += 2 * y + 1;
+        } else {
+            xo--;
+            erro += 2 * (y - xo + 1);
+        }
+
+        if (y > xo - t + 1) {
+            xi = y;
+        } else {
+            if (erri < 0) {
+                erri += 2 * y + 1;
+            } else {
+                xi--;
+                erri += 2 * (y - xi + 1);
+            }
+        }
+    }
+}
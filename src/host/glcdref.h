@@ -0,0 +1,31 @@
+#ifndef GLCDREF_H
+#define GLCDREF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "display/glcd.h"
+
+// Drawing as it was before composed strings, RLE spans and merged shapes:
+// full image decode, a pixel or a rectangle at a time. Clipping and
+// orientation come from glcdDrawPixel() and glcdDrawRect().
+
+// Returns image width
+int16_t ref_glcdDrawImage(const tImage *img, int16_t x, int16_t y,
+                          color_t color, color_t bgColor);
+
+// Uses font, colors, align and framing set by glcdSet...(), returns string width
+int16_t ref_glcdWriteString(const char *string, int16_t x, int16_t y);
+
+void ref_glcdDrawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, color_t color);
+void ref_glcdDrawRFrame(int16_t x, int16_t y, int16_t w, int16_t h, int16_t t, int16_t r,
+                        color_t color);
+void ref_glcdDrawCircle(int16_t xc, int16_t yc, int16_t r, color_t color);
+void ref_glcdDrawRing(int16_t xc, int16_t yc, int16_t r, int16_t t, color_t color);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GLCDREF_H
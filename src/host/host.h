@@ -0,0 +1,20 @@
+#ifndef HOST_H
+#define HOST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// Advance software timers and clock as the SysTick would do
+void hostTick(int32_t ms);
+
+// Peak amplitude of the synthetic ADC signal, 0..2047
+void hostSpSetAmplitude(int16_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_H
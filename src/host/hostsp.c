@@ -0,0 +1,102 @@
+#include "host.h"
+
+#include <math.h>
+
+#include "spectrum.h"
+
+// Spectrum input for the host: instead of ADC DMA each call gets
+// a new block of synthetic stereo signal, processed as spGetADC() does
+
+static Spectrum spectrum = {
+    .mode = SP_MODE_STEREO,
+    .flags = SP_FLAG_PEAKS,
+    .scale = SP_SCALE,
+};
+
+static int16_t amplitude = 1024;
+static uint32_t blockNum;
+static uint32_t noise = 12345;
+
+static FftSample block[FFT_SIZE];
+
+static int16_t spNoise(void)
+{
+    noise = noise * 1103515245 + 12345;
+
+    return (int16_t)((noise >> 16) & 0x0F) - 8;
+}
+
+// Sum of a few tones with amplitudes changing from block to block
+static int16_t spSignal(uint8_t chan, int16_t i)
+{
+    static const float freq[SP_CHAN_END][4] = {
+        {3.0f, 21.5f, 77.0f, 260.0f},
+        {5.0f, 33.0f, 120.5f, 390.0f},
+    };
+    float sum = 0;
+
+    for (uint8_t k = 0; k < 4; k++) {
+        float env = 0.5f + 0.5f * sinf((float)(blockNum * (k + 1 + chan)) * 0.13f);
+        sum += env * sinf(2.0f * (float)M_PI * freq[chan][k] * (float)i / FFT_SIZE) / 4;
+    }
+
+    int32_t value = 2048 + (int32_t)(sum * amplitude) + spNoise();
+
+    return (int16_t)(value < 0 ? 0 : (value > 4095 ? 4095 : value));
+}
+
+void hostSpSetAmplitude(int16_t value)
+{
+    amplitude = value;
+}
+
+Spectrum *spGet(void)
+{
+    return &spectrum;
+}
+
+bool spIsReady(void)
+{
+    return true;
+}
+
+bool spGetADC(SpChan chan, uint8_t *out, size_t size, fftGet fn)
+{
+    int16_t *data = &block[0].fr;
+    int32_t dcOftL = 0;
+    int32_t dcOftR = 0;
+
+    // Same layout as DMA data set: left in fr, right in fi
+    for (int16_t i = 0; i < FFT_SIZE; i++) {
+        block[i].fr = spSignal(SP_CHAN_LEFT, i);
+        block[i].fi = spSignal(SP_CHAN_RIGHT, i);
+        dcOftL += block[i].fr;
+        dcOftR += block[i].fi;
+    }
+    dcOftL /= FFT_SIZE;
+    dcOftR /= FFT_SIZE;
+    blockNum++;
+
+    if (chan == SP_CHAN_BOTH) {
+        fft_prepare(block, data + SP_CHAN_LEFT, data + SP_CHAN_RIGHT, SP_CHAN_END,
+                    (int16_t)dcOftL, (int16_t)dcOftR);
+    } else {
+        fft_prepare(block, data + chan, NULL, SP_CHAN_END,
+                    (int16_t)(chan == SP_CHAN_LEFT ? dcOftL : dcOftR), 0);
+    }
+
+    int8_t exp = fft_radix4_bfp(block);
+
+    if (chan == SP_CHAN_BOTH) {
+        fft_split(block);
+    }
+
+    if (NULL != fn) {
+        fn(block, exp, out, size);
+        if (chan == SP_CHAN_BOTH) {
+            fn(block + FFT_SIZE / 2, exp, out + size, size);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,12 @@
+#include "spcolsimd.h"
+
+#include "dspref.h"
+
+// Public names get simd_ prefix to link together with the word-at-a-time build
+
+#define spectrumColumnCalc8     simd_spectrumColumnCalc8
+#define spectrumColumnCalc16    simd_spectrumColumnCalc16
+#define spectrumColumnDraw      simd_spectrumColumnDraw
+
+#define _SPCOL_SIMD
+#include "gui/widget/spectrumcolumn.c"
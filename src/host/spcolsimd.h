@@ -0,0 +1,22 @@
+#ifndef SPCOLSIMD_H
+#define SPCOLSIMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gui/widget/spectrumcolumn.h"
+
+// spectrumcolumn.c built with _SPCOL_SIMD, on the host it runs SEL/UQSUB
+// lanes with portable versions of the DSP intrinsics
+
+void simd_spectrumColumnCalc8(uint8_t *show, uint8_t *prev, uint8_t *peak, uint8_t *fall,
+                              const uint8_t *raw, int16_t count);
+void simd_spectrumColumnCalc16(uint16_t *show, uint16_t *prev, uint16_t *peak, uint16_t *fall,
+                               const uint16_t *raw, int16_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPCOLSIMD_H
@@ -0,0 +1,158 @@
+#include "host.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "amp.h"
+#include "audio/audio.h"
+#include "bt.h"
+#include "menu.h"
+#include "mpc.h"
+#include "rtc.h"
+#include "settings.h"
+#include "swtimers.h"
+#include "tuner/stations.h"
+#include "tuner/tuner.h"
+#include "utils.h"
+
+// Host side of the modules used by GUI: state is kept in memory
+// and changed by the host program between frames
+
+static Amp amp;
+static AudioProc aProc;
+static BTCtx btCtx;
+static Menu menu;
+static Mpc mpc;
+static RTC_type rtc = {.hour = 12, .min = 34, .sec = 56, .date = 17, .month = 10, .year = 26, .wday = 6,
+                       .etm = RTC_NOEDIT,
+                      };
+static Tuner tuner;
+
+static int32_t swTimers[SW_TIM_END];
+static int32_t rtcMs;
+
+static const AudioApi aApi;
+
+static const AudioGrid volGrid = {NULL, -79, 0, (int8_t)(1.00 * STEP_MULT)};
+
+void hostTick(int32_t ms)
+{
+    for (uint8_t i = 0; i < SW_TIM_DEC_END; i++) {
+        swTimers[i] = swTimers[i] > ms ? swTimers[i] - ms : (swTimers[i] > 0 ? 0 : swTimers[i]);
+    }
+    swTimers[SW_TIM_SYSTEM] += ms;
+
+    for (rtcMs += ms; rtcMs >= 1000; rtcMs -= 1000) {
+        if (++rtc.sec >= 60) {
+            rtc.sec = 0;
+            if (++rtc.min >= 60) {
+                rtc.min = 0;
+                rtc.hour = (rtc.hour + 1) % 24;
+            }
+        }
+    }
+}
+
+void utilmDelay(uint32_t ms)
+{
+    (void)ms;
+}
+
+int16_t settingsRead(Param param, int16_t defValue)
+{
+    (void)param;
+
+    return defValue;
+}
+
+void settingsStore(Param param, int16_t value)
+{
+    (void)param;
+    (void)value;
+}
+
+void swTimSet(SwTimer timer, int32_t value)
+{
+    swTimers[timer] = value;
+}
+
+int32_t swTimGet(SwTimer timer)
+{
+    return swTimers[timer];
+}
+
+Amp *ampGet(void)
+{
+    return &amp;
+}
+
+AudioProc *audioGet(void)
+{
+    // Any API makes the tune screens drawn
+    aProc.api = &aApi;
+    aProc.par.grid[AUDIO_TUNE_VOLUME] = &volGrid;
+
+    return &aProc;
+}
+
+BTCtx *btCtxGet(void)
+{
+    return &btCtx;
+}
+
+BtInput btGetInput(void)
+{
+    return btCtx.input;
+}
+
+char *btGetSongName(void)
+{
+    return btCtx.songName;
+}
+
+Menu *menuGet(void)
+{
+    return &menu;
+}
+
+void menuGetName(MenuIdx index, char *str, size_t len)
+{
+    snprintf(str, len, "Menu item %d", index);
+}
+
+void menuGetValueStr(MenuIdx index, char *str, size_t len)
+{
+    snprintf(str, len, "%d", index * 3);
+}
+
+Mpc *mpcGet(void)
+{
+    return &mpc;
+}
+
+void rtcGetTime(RTC_type *value)
+{
+    *value = rtc;
+}
+
+RtcMode rtcGetMode(void)
+{
+    return rtc.etm;
+}
+
+int8_t stationGetNum(uint16_t freq)
+{
+    return freq == 10170 ? 5 : -1;
+}
+
+char *stationGetName(int8_t num)
+{
+    static char name[] = "Host Radio";
+
+    return num >= 0 ? name : "";
+}
+
+Tuner *tunerGet(void)
+{
+    return &tuner;
+}
@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "fft.h"
+#include "fftref.h"
+#include "spectrum.h"
+
+// ADC blocks from files in DMA layout (interleaved left/right 12-bit samples)
+// through fft_prepare() and fft_radix4_bfp() against the reference steps.
+// Output must be bit-exact for both packed stereo and single channels.
+
+static bool checkBlock(const SpDataSet *data, SpChan chan, const char *name, long num)
+{
+    FftSample sp[FFT_SIZE];
+    FftSample ref[FFT_SIZE];
+    int32_t dc[SP_CHAN_END] = {0, 0};
+
+    for (int16_t i = 0; i < FFT_SIZE; i++) {
+        dc[SP_CHAN_LEFT] += data[i].chan[SP_CHAN_LEFT];
+        dc[SP_CHAN_RIGHT] += data[i].chan[SP_CHAN_RIGHT];
+    }
+    dc[SP_CHAN_LEFT] /= FFT_SIZE;
+    dc[SP_CHAN_RIGHT] /= FFT_SIZE;
+
+    const int16_t *re = &data->chan[chan == SP_CHAN_RIGHT ? SP_CHAN_RIGHT : SP_CHAN_LEFT];
+    const int16_t *im = chan == SP_CHAN_BOTH ? &data->chan[SP_CHAN_RIGHT] : NULL;
+    int16_t dcRe = (int16_t)dc[chan == SP_CHAN_RIGHT ? SP_CHAN_RIGHT : SP_CHAN_LEFT];
+    int16_t dcIm = im ? (int16_t)dc[SP_CHAN_RIGHT] : 0;
+
+    fft_prepare(sp, re, im, SP_CHAN_END, dcRe, dcIm);
+    ref_fft_prepare(ref, re, im, SP_CHAN_END, dcRe, dcIm);
+
+    if (memcmp(sp, ref, sizeof(sp))) {
+        printf("%s block %ld chan %d: fft_prepare() differs\n", name, num, chan);
+        return false;
+    }
+
+    int8_t exp = fft_radix4_bfp(sp);
+    int8_t refExp = ref_fft_radix4(ref, true);
+
+    if (exp != refExp || memcmp(sp, ref, sizeof(sp))) {
+        printf("%s block %ld chan %d: fft_radix4_bfp() differs, exp %d/%d\n",
+               name, num, chan, exp, refExp);
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    bool ok = true;
+
+    if (argc < 2) {
+        printf("usage: %s adc.raw...\n", argv[0]);
+        return 2;
+    }
+
+    for (int f = 1; f < argc; f++) {
+        FILE *file = fopen(argv[f], "rb");
+        SpDataSet data[FFT_SIZE];
+        long num = 0;
+        long fails = 0;
+
+        if (!file) {
+            printf("%s: can't open\n", argv[f]);
+            return 2;
+        }
+
+        while (fread(data, sizeof(data), 1, file) == 1) {
+            for (SpChan chan = SP_CHAN_LEFT; chan <= SP_CHAN_BOTH; chan++) {
+                if (!checkBlock(data, chan, argv[f], num)) {
+                    fails++;
+                }
+            }
+            num++;
+        }
+        fclose(file);
+
+        printf("%s: %ld blocks, %ld failed\n", argv[f], num, fails);
+        ok &= num > 0 && fails == 0;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fft.h"
+#include "fftsimd.h"
+
+// Packed kernel (_FFT_SIMD with reference intrinsics) against the scalar
+// one: fft_prepare(), fft_radix4_bfp() and fft_split() must be bit-exact
+
+#define BLOCKS          2000
+
+typedef struct {
+    int16_t re[FFT_SIZE];
+    int16_t im[FFT_SIZE];
+} Input;
+
+// Random tones and noise up to amp, full 12-bit scale clips at 0 and 4095
+static void fillInput(Input *in, int amp, bool packed)
+{
+    double f1 = rand() % 500 + rand() / (double)RAND_MAX;
+    double f2 = rand() % 500 + rand() / (double)RAND_MAX;
+    double a1 = rand() % (amp + 1);
+    double a2 = rand() % (amp + 1);
+
+    for (int i = 0; i < FFT_SIZE; i++) {
+        double re = a1 * sin(2 * M_PI * f1 * i / FFT_SIZE) + rand() % 64 - 32;
+        double im = a2 * sin(2 * M_PI * f2 * i / FFT_SIZE) + rand() % 64 - 32;
+
+        re = fmin(fmax(2048 + re, 0), 4095);
+        im = fmin(fmax(2048 + im, 0), 4095);
+
+        in->re[i] = (int16_t)re;
+        in->im[i] = packed ? (int16_t)im : 0;
+    }
+}
+
+static bool check(const Input *in, bool packed)
+{
+    FftSample sc[FFT_SIZE];
+    FftSample si[FFT_SIZE];
+    const int16_t *im = packed ? in->im : NULL;
+
+    fft_prepare(sc, in->re, im, 1, 2048, 2048);
+    simd_fft_prepare(si, in->re, im, 1, 2048, 2048);
+
+    int8_t expSc = fft_radix4_bfp(sc);
+    int8_t expSi = simd_fft_radix4_bfp(si);
+
+    if (packed) {
+        fft_split(sc);
+        simd_fft_split(si);
+    }
+
+    return expSc == expSi && !memcmp(sc, si, sizeof(sc));
+}
+
+int main(void)
+{
+    static const int amps[] = {4000, 2047, 500, 50, 0};
+    bool ok = true;
+
+    srand(3);
+
+    for (size_t a = 0; a < sizeof(amps) / sizeof(amps[0]); a++) {
+        long fails = 0;
+
+        for (int b = 0; b < BLOCKS; b++) {
+            Input in;
+            bool packed = b & 1;
+
+            fillInput(&in, amps[a], packed);
+            if (!check(&in, packed)) {
+                fails++;
+            }
+        }
+
+        printf("amplitude %4d: %d blocks, %ld failed\n", amps[a], BLOCKS, fails);
+        ok &= fails == 0;
+    }
+
+    // Extremes: full scale square wave in both parts
+    Input in;
+    for (int i = 0; i < FFT_SIZE; i++) {
+        in.re[i] = (i & 1) ? 4095 : 0;
+        in.im[i] = (i & 2) ? 0 : 4095;
+    }
+    bool pass = check(&in, true) && check(&in, false);
+
+    printf("full scale square: %s\n", pass ? "ok" : "FAIL");
+    ok &= pass;
+
+    return ok ? 0 : 1;
+}
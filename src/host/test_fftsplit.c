@@ -0,0 +1,125 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fft.h"
+#include "fftref.h"
+#include "spectrum.h"
+
+// Stereo spectrum by one packed FFT and split against two FFTs of single
+// channels, as spDoFft() does for SP_CHAN_BOTH and SP_CHAN_LEFT/RIGHT.
+// Both are measured against DFT in double of the same windowed samples.
+
+#define BLOCKS          100
+
+// Packed FFT may lose to two FFTs not more than this
+#define SNR_LOSS_MAX    3.0
+// Minimum SNR over all blocks at any amplitude
+#define SNR_MIN         20.0
+
+static uint16_t revBits(uint16_t n)
+{
+    uint16_t r = 0;
+
+    for (uint8_t b = 0; b < FFT_LOG2; b++) {
+        r = (uint16_t)((r << 1) | ((n >> b) & 1));
+    }
+
+    return r;
+}
+
+// DFT of the channel after fft_prepare(), which leaves it bit-reversed
+static void dft(const FftSample *prep, double *re, double *im)
+{
+    double x[FFT_SIZE];
+
+    for (int n = 0; n < FFT_SIZE; n++) {
+        x[n] = prep[revBits((uint16_t)n)].fr;
+    }
+
+    ref_dft(x, re, im);
+}
+
+static void fillBlock(SpDataSet *data, int amp)
+{
+    double ampL = rand() % amp;
+    double ampR = rand() % amp;
+    double fL = rand() % 400 + 1.3;
+    double fR = rand() % 400 + 0.7;
+
+    for (int i = 0; i < FFT_SIZE; i++) {
+        double l = ampL * sin(2 * M_PI * fL * i / FFT_SIZE) + ampL * 0.3 * sin(0.3 * i);
+        double r = ampR * sin(2 * M_PI * fR * i / FFT_SIZE);
+
+        data[i].chan[SP_CHAN_LEFT] = (int16_t)(2048 + l + rand() % 50);
+        data[i].chan[SP_CHAN_RIGHT] = (int16_t)(2048 + r + rand() % 50);
+    }
+}
+
+int main(void)
+{
+    static const int amps[] = {2000, 500, 100, 20};
+    bool ok = true;
+
+    srand(1);
+
+    for (size_t a = 0; a < sizeof(amps) / sizeof(amps[0]); a++) {
+        double sig = 0;
+        double errBoth = 0;
+        double errChan = 0;
+        double worst = INFINITY;
+
+        for (int b = 0; b < BLOCKS; b++) {
+            SpDataSet data[FFT_SIZE];
+            FftSample both[FFT_SIZE];
+            FftSample chan[FFT_SIZE];
+            int32_t dc[SP_CHAN_END] = {0, 0};
+
+            fillBlock(data, amps[a]);
+
+            for (int i = 0; i < FFT_SIZE; i++) {
+                dc[SP_CHAN_LEFT] += data[i].chan[SP_CHAN_LEFT];
+                dc[SP_CHAN_RIGHT] += data[i].chan[SP_CHAN_RIGHT];
+            }
+            dc[SP_CHAN_LEFT] /= FFT_SIZE;
+            dc[SP_CHAN_RIGHT] /= FFT_SIZE;
+
+            fft_prepare(both, &data->chan[SP_CHAN_LEFT], &data->chan[SP_CHAN_RIGHT], SP_CHAN_END,
+                        (int16_t)dc[SP_CHAN_LEFT], (int16_t)dc[SP_CHAN_RIGHT]);
+            int8_t exp = fft_radix4_bfp(both);
+            fft_split(both);
+
+            for (SpChan ch = SP_CHAN_LEFT; ch < SP_CHAN_END; ch++) {
+                double re[FFT_SIZE / 2];
+                double im[FFT_SIZE / 2];
+
+                fft_prepare(chan, &data->chan[ch], NULL, SP_CHAN_END, (int16_t)dc[ch], 0);
+                dft(chan, re, im);
+                int8_t chExp = fft_radix4_bfp(chan);
+
+                double s = ref_dft_power(re, im);
+                double eBoth = ref_dft_error(both + ch * FFT_SIZE / 2, exp, re, im);
+                double eChan = ref_dft_error(chan, chExp, re, im);
+
+                sig += s;
+                errBoth += eBoth;
+                errChan += eChan;
+
+                double snr = 10 * log10(s / eBoth);
+                if (snr < worst) {
+                    worst = snr;
+                }
+            }
+        }
+
+        double snrBoth = 10 * log10(sig / errBoth);
+        double snrChan = 10 * log10(sig / errChan);
+        bool pass = snrBoth >= snrChan - SNR_LOSS_MAX && worst >= SNR_MIN;
+
+        printf("amplitude %4d: SNR packed %.1f dB, two FFTs %.1f dB, worst block %.1f dB %s\n",
+               amps[a], snrBoth, snrChan, worst, pass ? "ok" : "FAIL");
+        ok &= pass;
+    }
+
+    return ok ? 0 : 1;
+}
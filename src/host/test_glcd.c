@@ -0,0 +1,364 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "display/dispdrv/virtual.h"
+#include "display/glcd.h"
+#include "glcdref.h"
+#include "gui/icons.h"
+#include "gui/layout.h"
+
+// Strings, images and shapes on the virtual panel, drawn by glcd and by the
+// former pixel and rectangle based renderer: frame buffers must be identical
+
+#define COLOR_CLEAR     0x18E3
+#define COLOR_FG        0xFFE0
+#define COLOR_BG        0x001F
+
+#define FAILS_SHOWN     10
+
+typedef int16_t (*Draw)(const void *arg, bool ref);
+
+typedef struct {
+    const char *name;
+    uint32_t cases;
+    uint32_t failed;
+} Result;
+
+typedef struct {
+    const tFont *font;
+    const char *text;
+    GlcdAlign align;
+    bool framed;
+    bool measured;                  // GlcdStr API instead of glcdWriteString()
+    int16_t x;
+    int16_t y;
+} StrCase;
+
+typedef struct {
+    const tImage *img;
+    int16_t x;
+    int16_t y;
+} ImgCase;
+
+typedef uint8_t ShapeType;
+enum {
+    SHAPE_LINE,
+    SHAPE_RFRAME,
+    SHAPE_CIRCLE,
+    SHAPE_RING,
+};
+
+typedef struct {
+    ShapeType type;
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+    int16_t t;
+    int16_t r;
+} ShapeCase;
+
+static const GlcdOrientation orients[] = {GLCD_LANDSCAPE, GLCD_PORTRATE};
+
+// Whole panel and a clipping window not aligned to anything
+static const GlcdRect clips[] = {
+    {0, 0, -1, -1},
+    {13, 17, 101, 47},
+};
+
+static uint16_t refFb[VIRTUAL_WIDTH * VIRTUAL_HEIGHT];
+
+static void setClip(const GlcdRect *clip)
+{
+    if (clip->w < 0) {
+        glcdResetRect();
+    } else {
+        glcdSetRectValues(clip->x, clip->y, clip->w, clip->h);
+    }
+}
+
+static void clear(void)
+{
+    GlcdRect clip = *glcdGetRect();
+
+    glcdResetRect();
+    glcdDrawRect(0, 0, glcdGetRect()->w, glcdGetRect()->h, COLOR_CLEAR);
+    glcdSetRectValues(clip.x, clip.y, clip.w, clip.h);
+}
+
+static void check(Result *res, Draw draw, const void *arg, const char *desc)
+{
+    clear();
+    int16_t refW = draw(arg, true);
+    memcpy(refFb, virtualGetFb(), sizeof(refFb));
+
+    clear();
+    int16_t w = draw(arg, false);
+
+    res->cases++;
+    if (w != refW || memcmp(refFb, virtualGetFb(), sizeof(refFb))) {
+        if (res->failed++ < FAILS_SHOWN) {
+            printf("%s: %s: width %d, expected %d\n", res->name, desc, w, refW);
+        }
+    }
+}
+
+static int16_t drawStr(const void *arg, bool ref)
+{
+    const StrCase *c = arg;
+
+    glcdSetFont(c->font);
+    glcdSetFontColor(COLOR_FG);
+    glcdSetFontBgColor(COLOR_BG);
+    glcdSetFontAlign(c->align);
+    glcdSetStringFramed(c->framed);
+
+    if (ref) {
+        return ref_glcdWriteString(c->text, c->x, c->y);
+    }
+
+    glcdSetXY(c->x, c->y);
+
+    if (c->measured) {
+        GlcdStr str;
+
+        glcdStrReset(&str);
+        glcdStrMeasure(&str, c->text);
+        return glcdStrWrite(&str);
+    }
+
+    return glcdWriteString(c->text);
+}
+
+static void testStrings(Result *res)
+{
+    static const tFont *fonts[] = {&fontterminus12, &fontterminus16, &fontterminus32};
+    static const char *texts[] = {
+        "",
+        "A",
+        "Volume -12dB",
+        "Громкость",
+        "\xE4\xBD\xA0 missing \xE4\xBD\xA0",
+        // More symbols than GlcdStr caches
+        "0123456789 abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ !?",
+    };
+
+    StrCase c;
+    char desc[128];
+
+    for (size_t o = 0; o < sizeof(orients) / sizeof(orients[0]); o++) {
+        glcdSetOrientation(orients[o]);
+
+        for (size_t cl = 0; cl < sizeof(clips) / sizeof(clips[0]); cl++) {
+            setClip(&clips[cl]);
+
+            int16_t w = glcdGetRect()->w;
+            int16_t h = glcdGetRect()->h;
+
+            const int16_t pos[][2] = {
+                {8, 4}, {w / 2, h / 2}, {-9, 6}, {w - 12, 10}, {20, -6}, {30, h - 10},
+            };
+
+            for (size_t f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++) {
+                for (size_t t = 0; t < sizeof(texts) / sizeof(texts[0]); t++) {
+                    for (size_t p = 0; p < sizeof(pos) / sizeof(pos[0]); p++) {
+                        for (uint8_t v = 0; v < 3 * 2 * 2; v++) {
+                            c.font = fonts[f];
+                            c.text = texts[t];
+                            c.align = v % 3;
+                            c.framed = (v / 3) % 2;
+                            c.measured = v / 6;
+                            c.x = pos[p][0];
+                            c.y = pos[p][1];
+
+                            snprintf(desc, sizeof(desc),
+                                     "orient %d clip %d font %d text %d pos %d,%d align %d framed %d api %d",
+                                     orients[o], (int)cl, (int)f, (int)t, c.x, c.y,
+                                     c.align, c.framed, c.measured);
+                            check(res, drawStr, &c, desc);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+static int16_t drawImg(const void *arg, bool ref)
+{
+    const ImgCase *c = arg;
+
+    if (ref) {
+        return ref_glcdDrawImage(c->img, c->x, c->y, COLOR_FG, COLOR_BG);
+    }
+
+    glcdSetXY(c->x, c->y);
+    glcdDrawImage(c->img, COLOR_FG, COLOR_BG);
+
+    return glcdGet()->x - c->x;
+}
+
+static void testImages(Result *res)
+{
+    static const tFont *fonts[] = {&fontterminusdig120, &fontterminus32, &iconsamp64};
+
+    ImgCase c;
+    char desc[128];
+
+    glcdResetRect();
+
+    for (size_t o = 0; o < sizeof(orients) / sizeof(orients[0]); o++) {
+        glcdSetOrientation(orients[o]);
+
+        int16_t w = glcdGetRect()->w;
+        int16_t h = glcdGetRect()->h;
+
+        for (size_t f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++) {
+            for (int16_t i = 0; i < fonts[f]->length; i++) {
+                c.img = fonts[f]->chars[i].image;
+
+                int16_t iw = c.img->width;
+                int16_t ih = c.img->height;
+
+                // Inside and clipped by every edge
+                const int16_t pos[][2] = {
+                    {0, 0}, {w / 3, h / 4}, {-iw / 2, 10}, {w - iw / 2, 10},
+                    {10, -ih / 2}, {10, h - ih / 2}, {-3, -5},
+                };
+
+                for (size_t p = 0; p < sizeof(pos) / sizeof(pos[0]); p++) {
+                    c.x = pos[p][0];
+                    c.y = pos[p][1];
+
+                    snprintf(desc, sizeof(desc), "orient %d font %d image %d pos %d,%d",
+                             orients[o], (int)f, i, c.x, c.y);
+                    check(res, drawImg, &c, desc);
+                }
+            }
+        }
+    }
+}
+
+static int16_t drawShape(const void *arg, bool ref)
+{
+    const ShapeCase *c = arg;
+
+    switch (c->type) {
+    case SHAPE_LINE:
+        (ref ? ref_glcdDrawLine : glcdDrawLine)(c->x, c->y, c->w, c->h, COLOR_FG);
+        break;
+    case SHAPE_RFRAME:
+        (ref ? ref_glcdDrawRFrame : glcdDrawRFrame)(c->x, c->y, c->w, c->h, c->t, c->r, COLOR_FG);
+        break;
+    case SHAPE_CIRCLE:
+        (ref ? ref_glcdDrawCircle : glcdDrawCircle)(c->x, c->y, c->r, COLOR_FG);
+        break;
+    case SHAPE_RING:
+        (ref ? ref_glcdDrawRing : glcdDrawRing)(c->x, c->y, c->r, c->t, COLOR_FG);
+        break;
+    }
+
+    return 0;
+}
+
+static void testShapes(Result *res)
+{
+    ShapeCase c;
+    char desc[128];
+
+    for (size_t o = 0; o < sizeof(orients) / sizeof(orients[0]); o++) {
+        glcdSetOrientation(orients[o]);
+
+        for (size_t cl = 0; cl < sizeof(clips) / sizeof(clips[0]); cl++) {
+            setClip(&clips[cl]);
+
+            int16_t w = glcdGetRect()->w;
+            int16_t h = glcdGetRect()->h;
+
+            // Lines from the middle and from outside to points around it
+            c.type = SHAPE_LINE;
+            for (int16_t d = -60; d <= 60; d += 7) {
+                const int16_t line[][4] = {
+                    {w / 2, h / 2, w / 2 + d, h / 2 + 40},
+                    {w / 2, h / 2, w / 2 + 40, h / 2 + d},
+                    {-20, h / 2, w / 2 + d, h / 2 - 30},
+                    {w / 2 + d, -15, w + 10, h / 2 + d},
+                };
+                for (size_t i = 0; i < sizeof(line) / sizeof(line[0]); i++) {
+                    c.x = line[i][0];
+                    c.y = line[i][1];
+                    c.w = line[i][2];
+                    c.h = line[i][3];
+
+                    snprintf(desc, sizeof(desc), "orient %d clip %d line %d,%d-%d,%d",
+                             orients[o], (int)cl, c.x, c.y, c.w, c.h);
+                    check(res, drawShape, &c, desc);
+                }
+            }
+
+            // Centered and clipped at the top left corner
+            const int16_t ctr[][2] = {{w / 2, h / 2}, {5, 3}};
+
+            for (size_t p = 0; p < sizeof(ctr) / sizeof(ctr[0]); p++) {
+                for (int16_t r = 0; r <= 40; r++) {
+                    c.type = SHAPE_CIRCLE;
+                    c.x = ctr[p][0];
+                    c.y = ctr[p][1];
+                    c.r = r;
+
+                    snprintf(desc, sizeof(desc), "orient %d clip %d circle %d,%d r %d",
+                             orients[o], (int)cl, c.x, c.y, c.r);
+                    check(res, drawShape, &c, desc);
+
+                    c.type = SHAPE_RING;
+                    for (c.t = 1; c.t <= r; c.t += (r > 8 ? 3 : 1)) {
+                        snprintf(desc, sizeof(desc), "orient %d clip %d ring %d,%d r %d t %d",
+                                 orients[o], (int)cl, c.x, c.y, c.r, c.t);
+                        check(res, drawShape, &c, desc);
+                    }
+                }
+
+                c.type = SHAPE_RFRAME;
+                c.x = ctr[p][0] - 40;
+                c.y = ctr[p][1] - 20;
+                for (c.r = 1; c.r <= 12; c.r++) {
+                    for (c.t = 1; c.t <= c.r; c.t++) {
+                        c.w = 2 * c.r + 2 + 3 * c.t;
+                        c.h = 2 * c.r + 2 + c.r;
+
+                        snprintf(desc, sizeof(desc),
+                                 "orient %d clip %d rframe %d,%d %dx%d t %d r %d",
+                                 orients[o], (int)cl, c.x, c.y, c.w, c.h, c.t, c.r);
+                        check(res, drawShape, &c, desc);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    Result results[] = {
+        {"strings", 0, 0},
+        {"images", 0, 0},
+        {"shapes", 0, 0},
+    };
+
+    glcdInit(GLCD_LANDSCAPE);
+
+    testStrings(&results[0]);
+    testImages(&results[1]);
+    testShapes(&results[2]);
+
+    int ret = 0;
+
+    for (size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++) {
+        printf("%-8s %6u cases, %u failed\n", results[i].name, results[i].cases, results[i].failed);
+        if (results[i].failed) {
+            ret = 1;
+        }
+    }
+
+    return ret;
+}
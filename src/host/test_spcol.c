@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "gui/widget/spectrumcolumn.h"
+#include "spcolsimd.h"
+
+// Column physics by words, both the portable word-at-a-time path and
+// the SEL/UQSUB path, against the former per column calcSpCol() step
+
+#define RUNS            400
+#define FRAMES          300
+#define COLS            128
+
+typedef void (*Calc8)(uint8_t *show, uint8_t *prev, uint8_t *peak, uint8_t *fall,
+                      const uint8_t *raw, int16_t count);
+typedef void (*Calc16)(uint16_t *show, uint16_t *prev, uint16_t *peak, uint16_t *fall,
+                       const uint16_t *raw, int16_t count);
+
+typedef struct {
+    const char *name;
+    Calc8 calc8;
+    Calc16 calc16;
+} Impl;
+
+static const Impl impls[] = {
+    {"word",    spectrumColumnCalc8,        spectrumColumnCalc16},
+    {"simd",    simd_spectrumColumnCalc8,   simd_spectrumColumnCalc16},
+};
+
+static uint32_t seed = 7;
+
+static uint16_t rnd(void)
+{
+    seed = seed * 1103515245 + 12345;
+
+    return (seed >> 16) & 0x7FFF;
+}
+
+// Column update as calcSpCol() did it, raw is already scaled
+static void refCalc(int16_t raw, SpectrumColumn *col)
+{
+    col->prevW = col->showW;
+    if (raw < col->showW) {
+        if (col->showW >= col->fallW) {
+            col->showW -= col->fallW;
+            col->fallW++;
+        } else {
+            col->showW = 0;
+        }
+    }
+
+    if (raw > col->showW) {
+        col->showW = raw;
+        col->fallW = 1;
+    }
+
+    if (col->peakW <= raw) {
+        col->peakW = raw + 1;
+    } else {
+        if (col->peakW && col->peakW > col->showW + 1) {
+            col->peakW--;
+        }
+    }
+}
+
+// Random, sparse and burst input
+static uint8_t getRaw(int mode, int frame)
+{
+    switch (mode) {
+    case 0:
+        return (uint8_t)(rnd() % 256);
+    case 1:
+        return (uint8_t)(rnd() % 8 == 0 ? rnd() % 256 : 0);
+    default:
+        return (uint8_t)(frame % 40 < 20 ? 255 - rnd() % 4 : rnd() % 3);
+    }
+}
+
+static long runImpl(const Impl *impl, long *updates)
+{
+    long fails = 0;
+
+    for (int run = 0; run < RUNS; run++) {
+        bool wide = run & 1;
+        int16_t scale = wide ? 100 + rnd() % 400 : 1 + rnd() % 255;
+        int16_t count = 1 + rnd() % COLS;
+        int mode = rnd() % 3;
+
+        SpectrumColumn ref[COLS];
+        uint8_t s8[COLS], o8[COLS], p8[COLS], f8[COLS], r8[COLS];
+        uint16_t s16[COLS], o16[COLS], p16[COLS], f16[COLS], r16[COLS];
+
+        memset(ref, 0, sizeof(ref));
+        memset(s8, 0, sizeof(s8));
+        memset(p8, 0, sizeof(p8));
+        memset(f8, 0, sizeof(f8));
+        memset(s16, 0, sizeof(s16));
+        memset(p16, 0, sizeof(p16));
+        memset(f16, 0, sizeof(f16));
+
+        for (int frame = 0; frame < FRAMES; frame++) {
+            bool silence = rnd() % 50 == 0;
+
+            memset(r8, 0, sizeof(r8));
+            memset(r16, 0, sizeof(r16));
+            for (int16_t i = 0; i < count; i++) {
+                int16_t raw = silence ? 0 : (int16_t)((scale * getRaw(mode, frame)) >> 8);
+
+                r8[i] = (uint8_t)raw;
+                r16[i] = (uint16_t)raw;
+                refCalc(raw, &ref[i]);
+            }
+
+            if (wide) {
+                impl->calc16(s16, o16, p16, f16, r16, count);
+            } else {
+                impl->calc8(s8, o8, p8, f8, r8, count);
+            }
+
+            for (int16_t i = 0; i < count; i++) {
+                int16_t s = wide ? s16[i] : s8[i];
+                int16_t o = wide ? o16[i] : o8[i];
+                int16_t p = wide ? p16[i] : p8[i];
+                int16_t f = wide ? f16[i] : f8[i];
+
+                if (s != ref[i].showW || o != ref[i].prevW || p != ref[i].peakW || f != ref[i].fallW) {
+                    if (fails < 5) {
+                        printf("%s: run %d frame %d col %d: %d %d %d %d, expected %d %d %d %d\n",
+                               impl->name, run, frame, i, s, o, p, f,
+                               ref[i].showW, ref[i].prevW, ref[i].peakW, ref[i].fallW);
+                    }
+                    fails++;
+                }
+                (*updates)++;
+            }
+        }
+    }
+
+    return fails;
+}
+
+int main(void)
+{
+    bool ok = true;
+
+    for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+        long updates = 0;
+        long fails = runImpl(&impls[i], &updates);
+
+        printf("%s: %ld column updates, %ld failed\n", impls[i].name, updates, fails);
+        ok &= fails == 0;
+    }
+
+    return ok ? 0 : 1;
+}
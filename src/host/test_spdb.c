@@ -0,0 +1,46 @@
+#include <stdio.h>
+
+// Built with spscale.c to reach dbTable
+#include "spscale.c"
+
+// spGetDb() against the binary search over dbTable for every input value
+
+static uint8_t refGetDb(uint16_t value)
+{
+    uint8_t min = 0;
+    uint8_t max = N_DB - 1;
+
+    uint8_t mid = (min + max) / 2;
+
+    while (min != mid && max != mid) {
+        if (dbTable[mid] < value) {
+            min = mid;
+        } else {
+            max = mid;
+        }
+        mid = (min + max) / 2;
+    }
+
+    return mid;
+}
+
+int main(void)
+{
+    uint32_t fails = 0;
+
+    for (uint32_t value = 0; value <= UINT16_MAX; value++) {
+        uint8_t db = spGetDb((uint16_t)value);
+        uint8_t ref = refGetDb((uint16_t)value);
+
+        if (db != ref) {
+            if (fails < 10) {
+                printf("value %u: %u, expected %u\n", value, db, ref);
+            }
+            fails++;
+        }
+    }
+
+    printf("spGetDb: 65536 values, %u failed\n", fails);
+
+    return fails ? 1 : 0;
+}
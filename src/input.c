@@ -1,6 +1,7 @@
 #include "input.h"
 
 #include "display/glcd.h"
+#include "events.h"
 #include "hwlibs.h"
 #include "settings.h"
 #include "timers.h"
@@ -90,8 +91,15 @@ void TIM_INPUT_HANDLER(void)
 
         uint8_t dispBus = ~glcdGetBus();
 
+        uint16_t btn = input.btn;
+        int8_t encCnt = input.encCnt;
+
         inputHandleButtons(dispBus & BTN_ALL);
         inputHandleEncoder(dispBus & ENC_AB);
+
+        if (input.btn != btn || input.encCnt != encCnt) {
+            eventPost(EVENT_INPUT);
+        }
     }
 }
 
@@ -6,6 +6,7 @@
 #include <string.h>
 
 #include "amp.h"
+#include "events.h"
 #include "hwlibs.h"
 #include "ringbuf.h"
 #include "usart.h"
@@ -350,6 +351,7 @@ void USART_MPC_HANDLER(void)
     if (LL_USART_IsActiveFlag_RXNE(USART_MPC) && LL_USART_IsEnabledIT_RXNE(USART_MPC)) {
         char data = LL_USART_ReceiveData8(USART_MPC);
         ringBufPushChar(&rbuf, data);
+        eventPost(EVENT_MPC);
     } else {
         // Call Error function
     }
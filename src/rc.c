@@ -3,6 +3,7 @@
 #include "hwlibs.h"
 
 #include "eemul.h"
+#include "events.h"
 #include "settings.h"
 #include "timers.h"
 
@@ -345,8 +346,14 @@ void EXTI_RC_HANDLER()
         // Clear RC line interrupt
         LL_EXTI_ClearFlag_0_31(RC_ExtiLine);
 
+        bool ready = rcData.ready;
+
         // Callback
         rcIRQ();
+
+        if (rcData.ready && !ready) {
+            eventPost(EVENT_RC);
+        }
     }
 }
 
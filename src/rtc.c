@@ -2,6 +2,7 @@
 
 #include "hwlibs.h"
 
+#include "events.h"
 #include "settings.h"
 #include "swtimers.h"
 
@@ -293,6 +294,7 @@ void RTC_IRQHandler(void)
         if (rtcCb) {
             rtcCb();
         }
+        eventPost(EVENT_RTC);
     }
 }
 #endif
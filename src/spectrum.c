@@ -1,59 +1,38 @@
 #include "spectrum.h"
 
+#include <string.h>
+
 #include "hwlibs.h"
 
+#include "events.h"
 #include "settings.h"
+#include "timers.h"
 #include "utils.h"
 
-#define DMA_BUF_SIZE        (FFT_SIZE * SP_CHAN_END)
+// STM32F3 only: ADC1 and ADC2 sample left and right channels simultaneously,
+// right channel input is moved from PA1 to PA4 (ADC2_IN1)
+#if defined(STM32F3) && defined(_SP_DUAL_ADC)
+#define SP_DUAL_ADC
+#endif
 
-static Spectrum spectrum;
+#define DMA_BLOCKS          2
+#define DMA_BUF_SIZE        (FFT_SIZE * SP_CHAN_END * DMA_BLOCKS)
 
-typedef struct {
-    int16_t chan[SP_CHAN_END];
-} SpDataSet;
+static Spectrum spectrum;
 
+// Ping-pong buffer: DMA fills one block while the other one is processed.
+// Processing is done in place, as a data set has the same layout as FftSample.
 typedef union {
-    SpDataSet dataSet[FFT_SIZE];
+    SpDataSet dataSet[DMA_BLOCKS][FFT_SIZE];
+    FftSample fftSample[DMA_BLOCKS][FFT_SIZE];
+    uint32_t dualADC[DMA_BLOCKS][FFT_SIZE];     // ADC1 in low, ADC2 in high halfword
     int16_t bufDMA[DMA_BUF_SIZE];
 } SpDMAData;
 
 static SpDMAData dmaData;
 
-static const uint16_t dbTable[N_DB] = {
-    640,   646,   651,   657,   663,   669,   676,   682,
-    689,   695,   702,   709,   715,   723,   730,   738,
-    746,   753,   762,   770,   778,   787,   796,   805,
-    813,   823,   833,   842,   853,   863,   874,   884,
-    896,   908,   918,   930,   942,   954,   967,   980,
-    993,   1006,  1019,  1033,  1047,  1062,  1077,  1092,
-    1108,  1123,  1139,  1157,  1174,  1192,  1209,  1227,
-    1245,  1264,  1284,  1303,  1323,  1344,  1365,  1386,
-    1410,  1431,  1454,  1478,  1502,  1526,  1551,  1577,
-    1603,  1629,  1658,  1686,  1715,  1743,  1773,  1804,
-    1834,  1866,  1899,  1932,  1967,  2001,  2036,  2073,
-    2110,  2147,  2187,  2227,  2267,  2308,  2350,  2393,
-    2438,  2483,  2530,  2576,  2624,  2674,  2725,  2775,
-    2828,  2881,  2937,  2993,  3049,  3108,  3169,  3230,
-    3292,  3355,  3422,  3488,  3556,  3626,  3697,  3770,
-    3845,  3920,  3998,  4077,  4158,  4242,  4327,  4413,
-    4502,  4592,  4685,  4779,  4875,  4974,  5075,  5178,
-    5284,  5391,  5502,  5614,  5729,  5847,  5967,  6089,
-    6215,  6343,  6474,  6607,  6745,  6884,  7027,  7173,
-    7322,  7475,  7630,  7790,  7952,  8119,  8290,  8462,
-    8640,  8822,  9008,  9197,  9391,  9589,  9791,  9998,
-    10209, 10425, 10645, 10871, 11102, 11338, 11578, 11825,
-    12076, 12333, 12595, 12863, 13138, 13418, 13705, 13997,
-    14297, 14603, 14915, 15234, 15562, 15895, 16235, 16585,
-    16940, 17304, 17676, 18056, 18445, 18842, 19247, 19662,
-    20087, 20519, 20962, 21414, 21878, 22349, 22831, 23325,
-    23829, 24345, 24871, 25411, 25960, 26523, 27097, 27685,
-    28284, 28897, 29525, 30165, 30820, 31490, 32173, 32872,
-    33586, 34316, 35062, 35824, 36603, 37399, 38212, 39045,
-    39895, 40763, 41651, 42558, 43485, 44433, 45401, 46391,
-    47403, 48435, 49492, 50571, 51675, 52802, 53955, 55132,
-    56335, 57566, 58823, 60107, 61420, 62763, 64133, 65535,
-};
+static volatile uint16_t dmaSeq;    // Number of completed DMA blocks
+static uint16_t readSeq;            // Value of dmaSeq at last read
 
 static void spInitDMA(void)
 {
@@ -71,27 +50,85 @@ static void spInitDMA(void)
                           LL_DMA_MODE_CIRCULAR              |
                           LL_DMA_PERIPH_NOINCREMENT         |
                           LL_DMA_MEMORY_INCREMENT           |
+#ifdef SP_DUAL_ADC
+                          LL_DMA_PDATAALIGN_WORD            |
+                          LL_DMA_MDATAALIGN_WORD            |
+#else
                           LL_DMA_PDATAALIGN_HALFWORD        |
                           LL_DMA_MDATAALIGN_HALFWORD        |
+#endif
                           LL_DMA_PRIORITY_HIGH               );
 
     // Set DMA transfer addresses of source and destination
     LL_DMA_ConfigAddresses(DMA1,
                            LL_DMA_CHANNEL_1,
+#ifdef SP_DUAL_ADC
+                           LL_ADC_DMA_GetRegAddr(ADC1, LL_ADC_DMA_REG_REGULAR_DATA_MULTI),
+#else
                            LL_ADC_DMA_GetRegAddr(ADC1, LL_ADC_DMA_REG_REGULAR_DATA),
+#endif
                            (uint32_t)&dmaData,
                            LL_DMA_DIRECTION_PERIPH_TO_MEMORY);
 
     // Set DMA transfer size
     LL_DMA_SetDataLength(DMA1,
                          LL_DMA_CHANNEL_1,
+#ifdef SP_DUAL_ADC
+                         DMA_BUF_SIZE / SP_CHAN_END);
+#else
                          DMA_BUF_SIZE);
+#endif
+
+    // Half and full transfer interrupts mark completed blocks
+    LL_DMA_EnableIT_HT(DMA1, LL_DMA_CHANNEL_1);
+    LL_DMA_EnableIT_TC(DMA1, LL_DMA_CHANNEL_1);
 
     // Enable the DMA transfer
     LL_DMA_EnableChannel(DMA1,
                          LL_DMA_CHANNEL_1);
 }
 
+#ifdef SP_DUAL_ADC
+static void spInitADC2(void)
+{
+    LL_GPIO_SetPinMode(GPIOA, LL_GPIO_PIN_4, LL_GPIO_MODE_ANALOG);
+    LL_GPIO_SetPinPull(GPIOA, LL_GPIO_PIN_4, LL_GPIO_PULL_NO);
+
+    if (LL_ADC_IsEnabled(ADC2)) {
+        return;
+    }
+
+    // ADC2 is a slave converting together with ADC1, data is read from the common register
+    LL_ADC_SetMultimode(__LL_ADC_COMMON_INSTANCE(ADC1), LL_ADC_MULTI_DUAL_REG_SIMULT);
+    LL_ADC_SetMultiDMATransfer(__LL_ADC_COMMON_INSTANCE(ADC1), LL_ADC_MULTI_REG_DMA_UNLMT_RES12_10B);
+
+    LL_ADC_SetResolution(ADC2, LL_ADC_RESOLUTION_12B);
+    LL_ADC_SetDataAlignment(ADC2, LL_ADC_DATA_ALIGN_RIGHT);
+    LL_ADC_REG_SetContinuousMode(ADC2, LL_ADC_REG_CONV_SINGLE);
+    LL_ADC_REG_SetOverrun(ADC2, LL_ADC_REG_OVR_DATA_OVERWRITTEN);
+
+    LL_ADC_REG_SetSequencerLength(ADC2, LL_ADC_REG_SEQ_SCAN_DISABLE);
+    LL_ADC_REG_SetSequencerRanks(ADC2, LL_ADC_REG_RANK_1, LL_ADC_CHANNEL_1);
+    LL_ADC_SetChannelSamplingTime(ADC2, LL_ADC_CHANNEL_1, LL_ADC_SAMPLINGTIME_61CYCLES_5);
+    LL_ADC_SetChannelSingleDiff(ADC2, LL_ADC_CHANNEL_1, LL_ADC_SINGLE_ENDED);
+
+    LL_ADC_SetAnalogWDMonitChannels(ADC2, LL_ADC_AWD1, LL_ADC_AWD_ALL_CHANNELS_REG);
+    LL_ADC_SetAnalogWDThresholds(ADC2, LL_ADC_AWD1, LL_ADC_AWD_THRESHOLD_LOW, 2047 - 512);
+    LL_ADC_SetAnalogWDThresholds(ADC2, LL_ADC_AWD1, LL_ADC_AWD_THRESHOLD_HIGH, 2047 + 512);
+
+    LL_ADC_EnableInternalRegulator(ADC2);
+    while (!LL_ADC_IsInternalRegulatorEnabled(ADC2));
+
+    LL_ADC_StartCalibration(ADC2, LL_ADC_SINGLE_ENDED);
+    while (LL_ADC_IsCalibrationOnGoing(ADC2) != 0);
+
+    utilmDelay(1);
+
+    LL_ADC_Enable(ADC2);
+    while (!LL_ADC_IsEnabled(ADC2));
+}
+#endif
+
 static void spInitADC(void)
 {
     // Configure NVIC to enable ADC1 interruptions
@@ -108,11 +145,19 @@ static void spInitADC(void)
 
     // Configure GPIO in analog mode to be used as ADC input
     LL_GPIO_SetPinMode(GPIOA, LL_GPIO_PIN_0, LL_GPIO_MODE_ANALOG);
+#ifndef SP_DUAL_ADC
     LL_GPIO_SetPinMode(GPIOA, LL_GPIO_PIN_1, LL_GPIO_MODE_ANALOG);
+#endif
 #ifdef STM32F3
     LL_GPIO_SetPinPull(GPIOA, LL_GPIO_PIN_0, LL_GPIO_PULL_NO);
+#ifndef SP_DUAL_ADC
     LL_GPIO_SetPinPull(GPIOA, LL_GPIO_PIN_1, LL_GPIO_PULL_NO);
 #endif
+#endif
+
+#ifdef SP_DUAL_ADC
+    spInitADC2();
+#endif
 
     if (!LL_ADC_IsEnabled(ADC1)) {
         // Set ADC conversion data alignment
@@ -123,17 +168,30 @@ static void spInitADC(void)
         LL_ADC_SetSequencersScanMode(ADC1, LL_ADC_SEQ_SCAN_ENABLE);
 #endif
 
-        // Set ADC group regular trigger source
-        LL_ADC_REG_SetTriggerSource(ADC1, LL_ADC_REG_TRIG_SOFTWARE);
+        // Set ADC group regular trigger source: TIM_SPECTRUM (TIM2) is the sample clock
+#ifdef STM32F1
+        // There is no TIM2 TRGO trigger for ADC1 on F1, channel 2 compare event is used
+        LL_ADC_REG_SetTriggerSource(ADC1, LL_ADC_REG_TRIG_EXT_TIM2_CH2);
+#endif
+#ifdef STM32F3
+        LL_ADC_REG_SetTriggerSource(ADC1, LL_ADC_REG_TRIG_EXT_TIM2_TRGO_ADC12);
+#endif
 
         // Set ADC group regular continuous mode
         LL_ADC_REG_SetContinuousMode(ADC1, LL_ADC_REG_CONV_SINGLE);
 
+#ifdef SP_DUAL_ADC
+        // Data of both ADCs is transferred by multimode DMA
+        LL_ADC_REG_SetDMATransfer(ADC1, LL_ADC_REG_DMA_TRANSFER_NONE);
+
+        LL_ADC_REG_SetSequencerLength(ADC1, LL_ADC_REG_SEQ_SCAN_DISABLE);
+#else
         // Set ADC group regular conversion data transfer
         LL_ADC_REG_SetDMATransfer(ADC1, LL_ADC_REG_DMA_TRANSFER_UNLIMITED);
 
         // Set ADC group regular sequencer length and scan direction
         LL_ADC_REG_SetSequencerLength(ADC1, LL_ADC_REG_SEQ_SCAN_ENABLE_2RANKS);
+#endif
 
 #ifdef STM32F1
         LL_ADC_REG_SetSequencerRanks(ADC1, LL_ADC_REG_RANK_1, LL_ADC_CHANNEL_0);
@@ -149,10 +207,12 @@ static void spInitADC(void)
         LL_ADC_SetChannelSamplingTime(ADC1, LL_ADC_CHANNEL_1, LL_ADC_SAMPLINGTIME_61CYCLES_5);
         LL_ADC_SetChannelSingleDiff(ADC1, LL_ADC_CHANNEL_1, LL_ADC_SINGLE_ENDED);
 
+#ifndef SP_DUAL_ADC
         LL_ADC_REG_SetSequencerRanks(ADC1, LL_ADC_REG_RANK_2, LL_ADC_CHANNEL_2);
         LL_ADC_SetChannelSamplingTime(ADC1, LL_ADC_CHANNEL_2, LL_ADC_SAMPLINGTIME_61CYCLES_5);
         LL_ADC_SetChannelSingleDiff(ADC1, LL_ADC_CHANNEL_2, LL_ADC_SINGLE_ENDED);
 #endif
+#endif
 
 #ifdef STM32F1
         LL_ADC_SetAnalogWDMonitChannels(ADC1, LL_ADC_AWD_ALL_CHANNELS_REG);
@@ -176,6 +236,8 @@ static void spInitADC(void)
 
         LL_ADC_StartCalibration(ADC1);
         while (LL_ADC_IsCalibrationOnGoing(ADC1) != 0);
+
+        LL_ADC_REG_StartConversionExtTrig(ADC1, LL_ADC_REG_TRIG_EXT_RISING);
 #endif
 #ifdef STM32F3
         LL_ADC_EnableInternalRegulator(ADC1);
@@ -188,29 +250,45 @@ static void spInitADC(void)
 
         LL_ADC_Enable(ADC1);
         while (!LL_ADC_IsEnabled(ADC1));
+
+        // Conversions will start on trigger events
+        LL_ADC_REG_StartConversion(ADC1);
 #endif
     }
 }
 
-static void spDoFft(int16_t *dma, FftSample *smpl)
+static int8_t spDoFft(SpChan chan, uint8_t block)
 {
-    int32_t dcOft = 0;
+    SpDataSet *data = dmaData.dataSet[block];
+    FftSample *smpl = dmaData.fftSample[block];
+
+    int32_t dcOftL = 0;
+    int32_t dcOftR = 0;
 
     for (int16_t i = 0; i < FFT_SIZE; i++) {
-        smpl[i].fr = dma[2 * i];
-        dcOft += smpl[i].fr;
+        dcOftL += data[i].chan[SP_CHAN_LEFT];
+        dcOftR += data[i].chan[SP_CHAN_RIGHT];
+    }
+    dcOftL /= FFT_SIZE;
+    dcOftR /= FFT_SIZE;
+
+    // Full ADC resolution is used, FFT scales the block only when needed
+    if (chan == SP_CHAN_BOTH) {
+        // Left channel goes to the real part, right one to the imaginary part
+        fft_prepare(smpl, &data->chan[SP_CHAN_LEFT], &data->chan[SP_CHAN_RIGHT], SP_CHAN_END,
+                    (int16_t)dcOftL, (int16_t)dcOftR);
+    } else {
+        fft_prepare(smpl, &data->chan[chan], NULL, SP_CHAN_END,
+                    (int16_t)(chan == SP_CHAN_LEFT ? dcOftL : dcOftR), 0);
     }
-    dcOft /= FFT_SIZE;
 
-    for (int16_t i = 0; i < FFT_SIZE; i++) {
-        smpl[i].fr -= dcOft;
-        smpl[i].fr >>= 2; // Use only 10 most significant bits for FFT
-        smpl[i].fi = 0;
+    int8_t exp = fft_radix4_bfp(smpl);
+
+    if (chan == SP_CHAN_BOTH) {
+        fft_split(smpl);
     }
 
-    fft_hamm_window(smpl);
-    fft_rev_bin(smpl);
-    fft_radix4(smpl);
+    return exp;
 }
 
 static void spReadSettings(void)
@@ -219,9 +297,16 @@ static void spReadSettings(void)
     bool peaks = (uint8_t)settingsRead(PARAM_SPECTRUM_PEAKS, true);
     bool grad = (uint8_t)settingsRead(PARAM_SPECTRUM_GRAD, false);
     bool demo = false;
+#ifdef _SP_BIN_SUM
+    bool sum = true;
+#else
+    bool sum = false;
+#endif
     spectrum.flags |= ((peaks ? SP_FLAG_PEAKS : SP_FLAG_NONE) |
                        (grad ? SP_FLAG_GRAD : SP_FLAG_NONE) |
-                       (demo ? SP_FLAG_DEMO : SP_FLAG_NONE));
+                       (demo ? SP_FLAG_DEMO : SP_FLAG_NONE) |
+                       (sum ? SP_FLAG_SUM : SP_FLAG_NONE));
+    spectrum.scale = SP_SCALE;
 }
 
 void spInit(void)
@@ -237,48 +322,72 @@ Spectrum *spGet(void)
     return &spectrum;
 }
 
-uint8_t spGetDb(uint16_t value)
+bool spIsReady(void)
 {
-    uint8_t min = 0;
-    uint8_t max = N_DB - 1;
+    return dmaSeq != readSeq;
+}
+
+bool spGetADC(SpChan chan, uint8_t *out, size_t size, fftGet fn)
+{
+    uint16_t seq = dmaSeq;
+
+    if (seq == readSeq) {
+        return false;
+    }
+    readSeq = seq;
+
+    // Odd sequence numbers are set by half transfer, even ones by full transfer
+    uint8_t block = (uint8_t)((seq - 1) % DMA_BLOCKS);
+    FftSample *smpl = dmaData.fftSample[block];
+
+    int8_t exp = spDoFft(chan, block);
+
+    // DMA has started to overwrite the block during FFT
+    if (dmaSeq != seq) {
+        return false;
+    }
 
-    uint8_t mid = (min + max) / 2;
+    if (NULL != fn) {
+        fn(smpl, exp, out, size);
+        if (chan == SP_CHAN_BOTH) {
+            fn(smpl + FFT_SIZE / 2, exp, out + size, size);
+        }
 
-    while (min != mid && max != mid) {
-        if (dbTable[mid] < value) {
-            min = mid;
-        } else {
-            max = mid;
+        // Or while the result was converted, don't leave it partly valid
+        if (dmaSeq != seq) {
+            memset(out, 0, chan == SP_CHAN_BOTH ? 2 * size : size);
+            return false;
         }
-        mid = (min + max) / 2;
     }
 
-    return mid;
+    return true;
 }
 
-void spGetADC(SpChan chan, uint8_t *out, size_t size, fftGet fn)
+static uint32_t spGetTimClock(void)
 {
-    int16_t *dma = &dmaData.dataSet->chan[chan];
-
-    FftSample smpl[FFT_SIZE];
+    LL_RCC_ClocksTypeDef clocks;
 
-    spDoFft(dma, smpl);
+    LL_RCC_GetSystemClocksFreq(&clocks);
 
-    if (NULL != fn) {
-        fn(smpl, out, size);
+    // APB1 timers run at twice PCLK1 when APB1 is divided
+    if (LL_RCC_GetAPB1Prescaler() == LL_RCC_APB1_DIV_1) {
+        return clocks.PCLK1_Frequency;
     }
+    return clocks.PCLK1_Frequency * 2;
 }
 
-void spConvertADC(void)
+void spInitTimer(void)
 {
-    if (LL_ADC_IsEnabled(ADC1) == 1) {
+    timerInit(TIM_SPECTRUM, spGetTimClock() / SP_TIM_TICK - 1, SP_TIM_RELOAD);
+
 #ifdef STM32F1
-        LL_ADC_REG_StartConversionSWStart(ADC1);
+    LL_TIM_OC_SetMode(TIM_SPECTRUM, LL_TIM_CHANNEL_CH2, LL_TIM_OCMODE_PWM1);
+    LL_TIM_OC_SetCompareCH2(TIM_SPECTRUM, (SP_TIM_RELOAD + 1) / 2);
+    LL_TIM_CC_EnableChannel(TIM_SPECTRUM, LL_TIM_CHANNEL_CH2);
 #endif
 #ifdef STM32F3
-        LL_ADC_REG_StartConversion(ADC1);
+    LL_TIM_SetTriggerOutput(TIM_SPECTRUM, LL_TIM_TRGO_UPDATE);
 #endif
-    }
 }
 
 bool spCheckSignal()
@@ -287,5 +396,25 @@ bool spCheckSignal()
 
     LL_ADC_ClearFlag_AWD1(ADC1);
 
+#ifdef SP_DUAL_ADC
+    ret |= LL_ADC_IsActiveFlag_AWD1(ADC2);
+
+    LL_ADC_ClearFlag_AWD1(ADC2);
+#endif
+
     return ret;
 }
+
+void DMA1_Channel1_IRQHandler(void)
+{
+    if (LL_DMA_IsActiveFlag_HT1(DMA1)) {
+        LL_DMA_ClearFlag_HT1(DMA1);
+        dmaSeq++;
+        eventPost(EVENT_SPECTRUM);
+    }
+    if (LL_DMA_IsActiveFlag_TC1(DMA1)) {
+        LL_DMA_ClearFlag_TC1(DMA1);
+        dmaSeq++;
+        eventPost(EVENT_SPECTRUM);
+    }
+}
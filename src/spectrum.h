@@ -20,6 +20,11 @@ enum {
     SP_CHAN_END = SP_CHAN_BOTH
 };
 
+// ADC sample set in DMA layout, interleaved left/right 12-bit samples
+typedef struct {
+    int16_t chan[SP_CHAN_END];
+} SpDataSet;
+
 typedef int8_t SpMode;
 enum {
     SP_MODE_NULL = -1,
@@ -46,6 +51,14 @@ enum {
 
 #define N_DB            256
 
+// ADC sample clock, generated by TIM_SPECTRUM. Its prescaler is derived
+// from the APB1 timer clock to count at SP_TIM_TICK
+#define SP_TIM_TICK         720000
+#ifndef SP_SAMPLE_RATE
+#define SP_SAMPLE_RATE      20000
+#endif
+#define SP_TIM_RELOAD       (SP_TIM_TICK / SP_SAMPLE_RATE - 1)
+
 typedef uint8_t SpFlags;
 enum {
     SP_FLAG_NONE    = 0x00,
@@ -53,24 +66,67 @@ enum {
     SP_FLAG_PEAKS   = 0x01,
     SP_FLAG_GRAD    = 0x02,
     SP_FLAG_DEMO    = 0x04,
+    SP_FLAG_SUM     = 0x08,     // Column shows power sum of its bins instead of peak
 };
 
+// Frequency scale of spectrum columns
+typedef uint8_t SpScale;
+enum {
+    SP_SCALE_LOG = 0,
+    SP_SCALE_OCT3,
+    SP_SCALE_OCT6,
+    SP_SCALE_LINEAR,
+
+    SP_SCALE_END
+};
+
+#ifndef SP_SCALE
+#define SP_SCALE            SP_SCALE_LOG
+#endif
+
+#define SP_FREQ_MIN         20      // Lower edge of octave scales, Hz
+
+#define SP_BIN_MAP_SIZE     128
+
+// Column i takes FFT bins from start[i] to start[i + 1] - 1
+typedef struct {
+    uint16_t start[SP_BIN_MAP_SIZE + 1];
+    uint8_t size;
+    SpScale scale;
+} SpBinMap;
+
 typedef struct {
     SpMode mode;
     SpFlags flags;
+    SpScale scale;
 } Spectrum;
 
-// Callback to convert FFT data
-typedef void (*fftGet)(FftSample *sp, uint8_t *out, size_t size);
+// Callback to convert FFT data, sp is scaled by 2^exp relative
+// to the spectrum of the 12-bit ADC data
+typedef void (*fftGet)(FftSample *sp, int8_t exp, uint8_t *out, size_t size);
 
 void spInit(void);
 Spectrum *spGet(void);
 
 uint8_t spGetDb(uint16_t value);
 
-void spGetADC(SpChan chan, uint8_t *out, size_t size, fftGet fn);
+// New completed ADC block is available
+bool spIsReady(void);
+
+// Processes the last completed ADC block, returns false if there is no new block
+// or it was overwritten by DMA during processing, out is not valid then.
+// With SP_CHAN_BOTH both channels are processed by a single FFT,
+// left channel is written to out and right channel to out + size
+bool spGetADC(SpChan chan, uint8_t *out, size_t size, fftGet fn);
+
+// Start sample clock timer, it's also used for display PWM
+void spInitTimer(void);
+
+// Build bin map for up to cols columns, octave scales may use less columns
+void spBuildBinMap(SpBinMap *map, SpScale scale, uint8_t cols);
 
-void spConvertADC(void);
+// Real sample rate in Hz, as rounded by the timer reload
+uint32_t spGetSampleRate(void);
 
 bool spCheckSignal(void);
 
@@ -2,6 +2,20 @@
 
 #include "hwlibs.h"
 
+#define SPI_DMA_MAX_LEN     0xFFFF
+
+typedef struct {
+    const uint16_t *data;
+    uint32_t count;
+    uint16_t fillWord;
+    bool fill;
+    bool wide;
+    volatile bool busy;
+    SpiDmaCb done;
+} SpiDma;
+
+static SpiDma spi2Dma;
+
 static void spiInitPins(SPI_TypeDef *SPIx, bool read)
 {
     LL_GPIO_InitTypeDef GPIO_InitStruct = {0};
@@ -88,3 +102,143 @@ void spiSendByte(void *spi, uint8_t data)
     LL_SPI_TransmitData8(SPIx, data);
 
 }
+
+static void spiSetDataWidth16(SPI_TypeDef *SPIx, bool wide)
+{
+    // Data width can be changed only when SPI is idle and disabled
+    spiWaitBusy(SPIx);
+    LL_SPI_Disable(SPIx);
+    LL_SPI_SetDataWidth(SPIx, wide ? LL_SPI_DATAWIDTH_16BIT : LL_SPI_DATAWIDTH_8BIT);
+    LL_SPI_Enable(SPIx);
+}
+
+static void spiInitDma(SPI_TypeDef *SPIx)
+{
+    LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA1);
+
+    NVIC_SetPriority(DMA1_Channel5_IRQn, 2);
+    NVIC_EnableIRQ(DMA1_Channel5_IRQn);
+
+    LL_DMA_ConfigTransfer(DMA1,
+                          LL_DMA_CHANNEL_5,
+                          LL_DMA_DIRECTION_MEMORY_TO_PERIPH |
+                          LL_DMA_MODE_NORMAL                |
+                          LL_DMA_PERIPH_NOINCREMENT         |
+                          LL_DMA_MEMORY_INCREMENT           |
+                          LL_DMA_PDATAALIGN_HALFWORD        |
+                          LL_DMA_MDATAALIGN_HALFWORD        |
+                          LL_DMA_PRIORITY_MEDIUM);
+
+    LL_DMA_SetPeriphAddress(DMA1, LL_DMA_CHANNEL_5, LL_SPI_DMA_GetRegAddr(SPIx));
+    LL_DMA_EnableIT_TC(DMA1, LL_DMA_CHANNEL_5);
+
+    LL_SPI_EnableDMAReq_TX(SPIx);
+}
+
+static void spiStartDmaChunk(SpiDma *dma)
+{
+    uint32_t len = dma->count > SPI_DMA_MAX_LEN ? SPI_DMA_MAX_LEN : dma->count;
+
+    LL_DMA_SetMemoryIncMode(DMA1, LL_DMA_CHANNEL_5,
+                            dma->fill ? LL_DMA_MEMORY_NOINCREMENT : LL_DMA_MEMORY_INCREMENT);
+    LL_DMA_SetMemoryAddress(DMA1, LL_DMA_CHANNEL_5,
+                            dma->fill ? (uint32_t)&dma->fillWord : (uint32_t)dma->data);
+    LL_DMA_SetDataLength(DMA1, LL_DMA_CHANNEL_5, len);
+    LL_DMA_EnableChannel(DMA1, LL_DMA_CHANNEL_5);
+}
+
+void spiSendDma16(void *spi, const uint16_t *data, uint32_t count, bool fill, SpiDmaCb done)
+{
+    SPI_TypeDef *SPIx = (SPI_TypeDef *)spi;
+
+    if (SPIx != SPI2) {
+        for (uint32_t i = 0; i < count; i++) {
+            spiSendByte(SPIx, *data >> 8);
+            spiSendByte(SPIx, *data & 0xFF);
+            if (!fill) {
+                data++;
+            }
+        }
+        if (done) {
+            spiWaitBusy(SPIx);
+            done();
+        }
+        return;
+    }
+
+    SpiDma *dma = &spi2Dma;
+
+    while (dma->busy);
+
+    if (count == 0) {
+        if (done) {
+            spiWaitBusy(SPIx);
+            done();
+        }
+        return;
+    }
+
+    if (!dma->wide) {
+        if (!LL_SPI_IsEnabledDMAReq_TX(SPIx)) {
+            spiInitDma(SPIx);
+        }
+        spiSetDataWidth16(SPIx, true);
+        dma->wide = true;
+    }
+
+    dma->data = data;
+    dma->fillWord = *data;
+    dma->count = count;
+    dma->fill = fill;
+    dma->done = done;
+    dma->busy = true;
+
+    spiStartDmaChunk(dma);
+}
+
+void spiWaitDma(void *spi)
+{
+    SPI_TypeDef *SPIx = (SPI_TypeDef *)spi;
+
+    if (SPIx != SPI2) {
+        return;
+    }
+
+    SpiDma *dma = &spi2Dma;
+
+    while (dma->busy);
+
+    // Back to 8-bit frames for commands
+    if (dma->wide) {
+        spiSetDataWidth16(SPIx, false);
+        dma->wide = false;
+    }
+}
+
+void DMA1_Channel5_IRQHandler(void)
+{
+    SpiDma *dma = &spi2Dma;
+
+    if (LL_DMA_IsActiveFlag_TC5(DMA1)) {
+        LL_DMA_ClearFlag_TC5(DMA1);
+        LL_DMA_DisableChannel(DMA1, LL_DMA_CHANNEL_5);
+
+        uint32_t len = dma->count > SPI_DMA_MAX_LEN ? SPI_DMA_MAX_LEN : dma->count;
+        dma->count -= len;
+        if (!dma->fill) {
+            dma->data += len;
+        }
+
+        if (dma->count) {
+            spiStartDmaChunk(dma);
+            return;
+        }
+
+        if (dma->done) {
+            // Last frames are still being shifted out
+            spiWaitBusy(SPI2);
+            dma->done();
+        }
+        dma->busy = false;
+    }
+}
@@ -14,6 +14,12 @@ void spiWaitBusy(void *spi);
 
 void spiSendByte(void *spi, uint8_t data);
 
+typedef void (*SpiDmaCb)(void);
+
+// 16-bit frames via DMA (SPI2 only), fill repeats the first word count times
+void spiSendDma16(void *spi, const uint16_t *data, uint32_t count, bool fill, SpiDmaCb done);
+void spiWaitDma(void *spi);
+
 #ifdef __cplusplus
 }
 #endif
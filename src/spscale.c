@@ -0,0 +1,174 @@
+#include "spectrum.h"
+
+#if defined(__arm__)
+#include "cmsis_compiler.h"
+#else
+#define __CLZ(x)            (uint8_t)__builtin_clz(x)
+#endif
+
+static const uint16_t dbTable[N_DB] = {
+    640,   646,   651,   657,   663,   669,   676,   682,
+    689,   695,   702,   709,   715,   723,   730,   738,
+    746,   753,   762,   770,   778,   787,   796,   805,
+    813,   823,   833,   842,   853,   863,   874,   884,
+    896,   908,   918,   930,   942,   954,   967,   980,
+    993,   1006,  1019,  1033,  1047,  1062,  1077,  1092,
+    1108,  1123,  1139,  1157,  1174,  1192,  1209,  1227,
+    1245,  1264,  1284,  1303,  1323,  1344,  1365,  1386,
+    1410,  1431,  1454,  1478,  1502,  1526,  1551,  1577,
+    1603,  1629,  1658,  1686,  1715,  1743,  1773,  1804,
+    1834,  1866,  1899,  1932,  1967,  2001,  2036,  2073,
+    2110,  2147,  2187,  2227,  2267,  2308,  2350,  2393,
+    2438,  2483,  2530,  2576,  2624,  2674,  2725,  2775,
+    2828,  2881,  2937,  2993,  3049,  3108,  3169,  3230,
+    3292,  3355,  3422,  3488,  3556,  3626,  3697,  3770,
+    3845,  3920,  3998,  4077,  4158,  4242,  4327,  4413,
+    4502,  4592,  4685,  4779,  4875,  4974,  5075,  5178,
+    5284,  5391,  5502,  5614,  5729,  5847,  5967,  6089,
+    6215,  6343,  6474,  6607,  6745,  6884,  7027,  7173,
+    7322,  7475,  7630,  7790,  7952,  8119,  8290,  8462,
+    8640,  8822,  9008,  9197,  9391,  9589,  9791,  9998,
+    10209, 10425, 10645, 10871, 11102, 11338, 11578, 11825,
+    12076, 12333, 12595, 12863, 13138, 13418, 13705, 13997,
+    14297, 14603, 14915, 15234, 15562, 15895, 16235, 16585,
+    16940, 17304, 17676, 18056, 18445, 18842, 19247, 19662,
+    20087, 20519, 20962, 21414, 21878, 22349, 22831, 23325,
+    23829, 24345, 24871, 25411, 25960, 26523, 27097, 27685,
+    28284, 28897, 29525, 30165, 30820, 31490, 32173, 32872,
+    33586, 34316, 35062, 35824, 36603, 37399, 38212, 39045,
+    39895, 40763, 41651, 42558, 43485, 44433, 45401, 46391,
+    47403, 48435, 49492, 50571, 51675, 52802, 53955, 55132,
+    56335, 57566, 58823, 60107, 61420, 62763, 64133, 65535,
+};
+
+// dbTable index for values with leading one at bits 9..15 and 6 next bits of mantissa,
+// it's either exact or one less than the result
+#define DB_LOG_EXP_MIN      9
+#define DB_LOG_MANT_BITS    6
+
+static const uint8_t dbLogTable[(16 - DB_LOG_EXP_MIN) << DB_LOG_MANT_BITS] = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   1,   2,   4,   5,   6,   7,   9,   10,  11,  12,  13,  14,  15,  16,  17,
+    18,  19,  20,  21,  22,  23,  24,  25,  25,  26,  27,  28,  29,  29,  30,  31,
+    31,  32,  33,  34,  34,  35,  36,  36,  37,  38,  38,  39,  39,  40,  41,  41,
+    42,  43,  44,  45,  46,  47,  48,  49,  50,  51,  52,  53,  54,  55,  56,  56,
+    57,  58,  59,  60,  60,  61,  62,  63,  63,  64,  65,  66,  66,  67,  68,  68,
+    69,  70,  70,  71,  71,  72,  73,  73,  74,  74,  75,  75,  76,  77,  77,  78,
+    78,  79,  79,  80,  80,  81,  81,  82,  82,  83,  83,  84,  84,  84,  85,  85,
+    86,  87,  88,  88,  89,  90,  91,  92,  92,  93,  94,  95,  95,  96,  97,  97,
+    98,  99,  99,  100, 101, 101, 102, 103, 103, 104, 104, 105, 106, 106, 107, 107,
+    108, 108, 109, 109, 110, 111, 111, 112, 112, 113, 113, 114, 114, 114, 115, 115,
+    116, 116, 117, 117, 118, 118, 119, 119, 119, 120, 120, 121, 121, 122, 122, 122,
+    123, 124, 124, 125, 126, 127, 127, 128, 129, 129, 130, 131, 131, 132, 133, 133,
+    134, 135, 135, 136, 136, 137, 138, 138, 139, 139, 140, 140, 141, 141, 142, 142,
+    143, 143, 144, 144, 145, 145, 146, 146, 147, 147, 148, 148, 149, 149, 150, 150,
+    150, 151, 151, 152, 152, 153, 153, 153, 154, 154, 155, 155, 155, 156, 156, 157,
+    157, 158, 158, 159, 160, 161, 161, 162, 163, 163, 164, 165, 165, 166, 166, 167,
+    168, 168, 169, 169, 170, 171, 171, 172, 172, 173, 173, 174, 174, 175, 175, 176,
+    176, 177, 177, 178, 178, 179, 179, 180, 180, 181, 181, 181, 182, 182, 183, 183,
+    184, 184, 184, 185, 185, 186, 186, 186, 187, 187, 188, 188, 188, 189, 189, 190,
+    190, 191, 191, 192, 193, 193, 194, 195, 195, 196, 197, 197, 198, 199, 199, 200,
+    200, 201, 202, 202, 203, 203, 204, 204, 205, 205, 206, 206, 207, 207, 208, 208,
+    209, 209, 210, 210, 211, 211, 212, 212, 213, 213, 214, 214, 214, 215, 215, 216,
+    216, 217, 217, 217, 218, 218, 219, 219, 219, 220, 220, 220, 221, 221, 222, 222,
+    222, 223, 224, 224, 225, 226, 227, 227, 228, 228, 229, 230, 230, 231, 232, 232,
+    233, 233, 234, 234, 235, 236, 236, 237, 237, 238, 238, 239, 239, 240, 240, 241,
+    241, 242, 242, 243, 243, 244, 244, 244, 245, 245, 246, 246, 247, 247, 247, 248,
+    248, 249, 249, 250, 250, 250, 251, 251, 252, 252, 252, 253, 253, 253, 254, 254,
+};
+
+uint8_t spGetDb(uint16_t value)
+{
+    if (value < (1 << DB_LOG_EXP_MIN)) {
+        return 0;
+    }
+
+    uint8_t exp = 31 - __CLZ(value);
+    uint8_t mant = (value >> (exp - DB_LOG_MANT_BITS)) & ((1 << DB_LOG_MANT_BITS) - 1);
+
+    uint8_t db = dbLogTable[((exp - DB_LOG_EXP_MIN) << DB_LOG_MANT_BITS) | mant];
+
+    if (db < N_DB - 2 && dbTable[db + 1] < value) {
+        db++;
+    }
+
+    return db;
+}
+
+// Fill column edges (in bins, Q16) growing by ratio (Q16), each column has at least one bin
+static uint8_t spCalcLogEdges(uint32_t *edge, uint32_t lo, uint32_t hi, uint32_t ratio, uint8_t cols)
+{
+    uint8_t n;
+
+    edge[0] = lo;
+
+    for (n = 0; n < cols && edge[n] < hi; n++) {
+        uint32_t next = (uint32_t)(((uint64_t)edge[n] * ratio) >> 16);
+        if (next < edge[n] + (1 << 16)) {
+            next = edge[n] + (1 << 16);
+        }
+        edge[n + 1] = next;
+    }
+
+    return n;
+}
+
+void spBuildBinMap(SpBinMap *map, SpScale scale, uint8_t cols)
+{
+    uint32_t edge[SP_BIN_MAP_SIZE + 1];
+
+    const uint32_t lo = 1 << 16;                  // Bin 0 is DC, skip it
+    const uint32_t hi = (FFT_SIZE / 2) << 16;
+
+    uint32_t ratio;
+    uint8_t n = 0;
+
+    if (cols > SP_BIN_MAP_SIZE) {
+        cols = SP_BIN_MAP_SIZE;
+    } else if (cols == 0) {
+        cols = 1;
+    }
+
+    switch (scale) {
+    case SP_SCALE_OCT3:
+    case SP_SCALE_OCT6:
+        // 2^(1/3) and 2^(1/6) in Q16
+        ratio = (scale == SP_SCALE_OCT3) ? 82570 : 73562;
+        {
+            uint32_t fMin = (uint32_t)(((uint64_t)SP_FREQ_MIN * FFT_SIZE << 16) / spGetSampleRate());
+            n = spCalcLogEdges(edge, fMin > lo ? fMin : lo, hi, ratio, cols);
+        }
+        break;
+    case SP_SCALE_LINEAR:
+        for (n = 0; n <= cols; n++) {
+            edge[n] = lo + (hi - lo) / cols * n;
+        }
+        n = cols;
+        break;
+    default:
+        // Find the largest ratio which fits all columns into the band
+        ratio = 1 << 16;
+        for (uint32_t step = 1 << 15; step; step >>= 1) {
+            if (spCalcLogEdges(edge, lo, hi, ratio + step, cols) == cols && edge[cols] <= hi) {
+                ratio += step;
+            }
+        }
+        n = spCalcLogEdges(edge, lo, hi, ratio, cols);
+        break;
+    }
+
+    // Edges are at least one bin apart, so truncation keeps columns non-empty
+    for (uint8_t i = 0; i < n; i++) {
+        map->start[i] = (uint16_t)(edge[i] >> 16);
+    }
+    // Last column ends at Nyquist frequency
+    map->start[n] = FFT_SIZE / 2;
+
+    map->size = n;
+    map->scale = scale;
+}
+
+uint32_t spGetSampleRate(void)
+{
+    return SP_TIM_TICK / (SP_TIM_RELOAD + 1);
+}
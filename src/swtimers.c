@@ -1,22 +1,34 @@
 #include "swtimers.h"
 
+#include <stdbool.h>
+
+#include "events.h"
 #include "hwlibs.h"
 
 static int32_t swTimers[SW_TIM_END];
 
-static void swTimUpdate(void)
+static bool swTimUpdate(void)
 {
+    bool expired = false;
+
     for (uint8_t i = 0; i < SW_TIM_DEC_END; i++) {
         if (swTimers[i] > 0) {
-            swTimers[i]--;
+            if (--swTimers[i] == 0) {
+                expired = true;
+            }
         }
     }
     swTimers[SW_TIM_SYSTEM]++;
+
+    return expired;
 }
 
 void SysTick_Handler(void)
 {
-    swTimUpdate();
+    if (swTimUpdate()) {
+        eventPost(EVENT_TIMER);
+    }
+    eventPost(EVENT_TICK);
 }
 
 void swTimInit(void)
@@ -106,11 +106,16 @@ void utilEnableSwd(bool value)
     if (value) {
         if (!swd) {
             LL_GPIO_AF_Remap_SWJ_NOJTAG();
+#ifdef _DEBUG
+            // Keep debugger attached while main loop sleeps in WFI, costs sleep current
+            LL_DBGMCU_EnableDBGSleepMode();
+#endif
             swd = true;
         }
     } else {
         if (swd) {
             LL_GPIO_AF_DisableRemap_SWJ();
+            LL_DBGMCU_DisableDBGSleepMode();
             swd = false;
         }
     }